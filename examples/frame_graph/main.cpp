@@ -0,0 +1,162 @@
+#include <glballistic/all.h>
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <cmath>
+#include <iostream>
+
+// Runs a small post-processing graph into offscreen framebuffers with a hidden window and
+// checks the result on the CPU, so it doubles as a headless smoke test for gl::FrameGraph.
+
+const char* fullscreenVS = R"(
+#version 430 core
+out vec2 uv;
+void main() {
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    uv = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+})";
+
+const char* fillFS = R"(
+#version 430 core
+uniform vec4 color;
+out vec4 FragColor;
+void main() { FragColor = color; })";
+
+const char* copyFS = R"(
+#version 430 core
+layout(binding = 0) uniform sampler2D source;
+in vec2 uv;
+out vec4 FragColor;
+void main() { FragColor = texture(source, uv); })";
+
+const char* invertCS = R"(
+#version 430 core
+layout(local_size_x = 8, local_size_y = 8) in;
+layout(binding = 0) uniform sampler2D source;
+layout(rgba8, binding = 0) writeonly uniform image2D target;
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, imageSize(target)))) return;
+    imageStore(target, p, vec4(1.0) - texelFetch(source, p, 0));
+})";
+
+static void buildProgram(gl::Shader& shader, const char* vs, const char* fs) {
+    shader.create();
+    shader.attachShader(GL_VERTEX_SHADER, vs);
+    shader.attachShader(GL_FRAGMENT_SHADER, fs);
+    shader.link();
+}
+
+int main() {
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "Frame Graph", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Failed to create an OpenGL 4.5 context" << std::endl;
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    gl::State::init();
+
+    const GLsizei size = 64;
+    gl::TextureDesc desc{size, size, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE};
+
+    gl::Texture2D output;
+    output.create(size, size, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    gl::VertexArray emptyVAO;
+    emptyVAO.create();
+
+    gl::Shader fill, copy, invert;
+    buildProgram(fill, fullscreenVS, fillFS);
+    buildProgram(copy, fullscreenVS, copyFS);
+    invert.create();
+    invert.attachShader(GL_COMPUTE_SHADER, invertCS);
+    invert.link();
+
+    gl::FrameGraph graph;
+    bool ok = true;
+
+    for (int frame = 0; frame < 3; frame++) {
+        graph.reset();
+        gl::FrameResource target = graph.importTexture("output", output);
+        gl::FrameResource scene, inverted, debug;
+
+        graph.addPass("scene", [&](gl::FrameGraph::Builder& b) {
+            scene = b.write(b.create("scene", desc));
+        }, [&](gl::PassContext&) {
+            const GLfloat color[4] = {0.25f, 0.5f, 1.0f, 1.0f};
+            fill.setUniform("color", color);
+            fill.use();
+            emptyVAO.drawArrays(GL_TRIANGLES, 0, 3);
+        });
+
+        // Only the culled pass below reads this, so compile() culls it.
+        graph.addPass("debug overlay", [&](gl::FrameGraph::Builder& b) {
+            debug = b.write(b.create("debug", desc));
+        }, [&](gl::PassContext&) {
+            std::cerr << "culled pass executed" << std::endl;
+        });
+
+        // Reads and writes its own target; that read alone must not keep it, or the overlay
+        // feeding it, alive.
+        graph.addPass("debug annotate", [&](gl::FrameGraph::Builder& b) {
+            b.read(debug, gl::Access::ImageRead);
+            b.write(debug, gl::Access::ImageWrite);
+        }, [&](gl::PassContext&) {
+            std::cerr << "culled pass executed" << std::endl;
+        });
+
+        graph.addPass("invert", [&](gl::FrameGraph::Builder& b) {
+            b.read(scene);
+            inverted = b.write(b.create("inverted", desc), gl::Access::ImageWrite);
+        }, [&](gl::PassContext& ctx) {
+            ctx.texture(scene).bind(0);
+            ctx.texture(inverted).bindImage(0, GL_WRITE_ONLY);
+            invert.dispatchCompute(size / 8, size / 8, 1);
+        });
+
+        graph.addPass("present", [&](gl::FrameGraph::Builder& b) {
+            b.read(inverted);
+            b.write(target);
+        }, [&](gl::PassContext& ctx) {
+            ctx.texture(inverted).bind(0);
+            copy.use();
+            emptyVAO.drawArrays(GL_TRIANGLES, 0, 3);
+        });
+
+        graph.compile();
+        graph.execute();
+
+        const gl::FrameGraphStats& stats = graph.stats();
+        std::cout << "frame " << frame << ": " << stats.passes << " passes, " << stats.culledPasses << " culled, "
+                  << stats.transientTextures << " transients on " << stats.physicalTextures << " textures, "
+                  << stats.barriers << " barriers, pool hit rate " << graph.poolStats().hitRate() << std::endl;
+
+        ok &= graph.culled("debug overlay") && graph.culled("debug annotate") && stats.barriers == 1;
+    }
+
+    unsigned char pixels[size * size * 4];
+    gl::State::bindFramebuffer(0);
+    output.getData(pixels);
+
+    const float expected[4] = {0.75f, 0.5f, 0.0f, 0.0f};
+    for (int c = 0; c < 4; c++) {
+        if (std::abs(pixels[c] / 255.0f - expected[c]) > 0.02f) {
+            std::cerr << "channel " << c << " is " << pixels[c] / 255.0f << ", expected " << expected[c] << std::endl;
+            ok = false;
+        }
+    }
+
+    std::cout << (ok ? "frame graph OK" : "frame graph FAILED") << std::endl;
+
+    graph.clear();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <glballistic/all.h>
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+
+// The pre-slot-table cache, kept here so both layouts are measured on the same machine.
+struct LegacyState {
+    static void bindBuffer(GLenum target, GLuint id) {
+        if (boundBuffers[target] != id) {
+            glBindBuffer(target, id);
+            boundBuffers[target] = id;
+        }
+    }
+
+    static void bindBufferBase(GLenum target, GLuint index, GLuint id) {
+        auto key = std::make_pair(target, index);
+        if (boundBases[key] != id) {
+            glBindBufferBase(target, index, id);
+            boundBases[key] = id;
+        }
+    }
+
+    static void bindTexture(GLuint unit, GLuint id) {
+        if (activeTexUnit != unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeTexUnit = unit;
+        }
+        if (boundTextureUnits[unit] != id) {
+            glBindTextureUnit(unit, id);
+            boundTextureUnits[unit] = id;
+        }
+    }
+
+    static inline std::unordered_map<GLenum, GLuint> boundBuffers;
+    static inline std::unordered_map<std::pair<GLenum, GLuint>, GLuint, gl::pair_hash> boundBases;
+    static inline std::unordered_map<GLuint, GLuint> boundTextureUnits;
+    static inline GLuint activeTexUnit = 0;
+};
+
+template<typename F>
+double nsPerCall(const char* name, int iterations, F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        fn(i);
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::cout << "  " << name << ": " << ns << " ns/call" << std::endl;
+    return ns;
+}
+
+int main() {
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "State Benchmark", nullptr, nullptr);
+    glfwMakeContextCurrent(window);
+    gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+
+    gl::State::init();
+
+    gl::Buffer vbo, ubo;
+    vbo.create(GL_ARRAY_BUFFER);
+    ubo.create(GL_UNIFORM_BUFFER);
+    ubo.data(256, nullptr, GL_DYNAMIC_DRAW);
+
+    gl::Texture2D tex;
+    tex.create(4, 4, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    const int iterations = 10'000'000;
+    const GLuint units = 8;
+
+    // Prime both caches so every measured call is elided.
+    for (GLuint u = 0; u < units; u++) {
+        LegacyState::bindTexture(u, tex.get());
+        gl::State::bindTexture(u, GL_TEXTURE_2D, tex.get());
+        LegacyState::bindBufferBase(GL_UNIFORM_BUFFER, u, ubo.get());
+        gl::State::bindBufferBase(GL_UNIFORM_BUFFER, u, ubo.get());
+    }
+    LegacyState::bindBuffer(GL_ARRAY_BUFFER, vbo.get());
+    gl::State::bindBuffer(GL_ARRAY_BUFFER, vbo.get());
+    LegacyState::bindBuffer(GL_UNIFORM_BUFFER, ubo.get());
+    gl::State::bindBuffer(GL_UNIFORM_BUFFER, ubo.get());
+
+    std::cout << "bindBuffer" << std::endl;
+    double a = nsPerCall("unordered_map", iterations, [&](int i) { LegacyState::bindBuffer(i & 1 ? GL_ARRAY_BUFFER : GL_UNIFORM_BUFFER, i & 1 ? vbo.get() : ubo.get()); });
+    double b = nsPerCall("slot table   ", iterations, [&](int i) { gl::State::bindBuffer(i & 1 ? GL_ARRAY_BUFFER : GL_UNIFORM_BUFFER, i & 1 ? vbo.get() : ubo.get()); });
+    std::cout << "  speedup: " << a / b << "x" << std::endl;
+
+    std::cout << "bindBufferBase" << std::endl;
+    a = nsPerCall("unordered_map", iterations, [&](int i) { LegacyState::bindBufferBase(GL_UNIFORM_BUFFER, i % units, ubo.get()); });
+    b = nsPerCall("slot table   ", iterations, [&](int i) { gl::State::bindBufferBase(GL_UNIFORM_BUFFER, i % units, ubo.get()); });
+    std::cout << "  speedup: " << a / b << "x" << std::endl;
+
+    // A fixed unit keeps the legacy glActiveTexture switch out of the lookup comparison.
+    std::cout << "bindTexture (fixed unit)" << std::endl;
+    a = nsPerCall("unordered_map", iterations, [&](int) { LegacyState::bindTexture(units - 1, tex.get()); });
+    b = nsPerCall("slot table   ", iterations, [&](int) { gl::State::bindTexture(units - 1, GL_TEXTURE_2D, tex.get()); });
+    std::cout << "  speedup: " << a / b << "x" << std::endl;
+
+    // Cycling units: the legacy path also issues glActiveTexture on every call, which the
+    // DSA slot table no longer needs, so this line measures that removal on top of the lookup.
+    std::cout << "bindTexture (cycling units, legacy issues glActiveTexture)" << std::endl;
+    a = nsPerCall("unordered_map", iterations, [&](int i) { LegacyState::bindTexture(i % units, tex.get()); });
+    b = nsPerCall("slot table   ", iterations, [&](int i) { gl::State::bindTexture(i % units, GL_TEXTURE_2D, tex.get()); });
+    std::cout << "  speedup: " << a / b << "x" << std::endl;
+
+    tex.destroy();
+    ubo.destroy();
+    vbo.destroy();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,295 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+    // Two-level segregated fit allocator over an abstract range of units (bytes, vertices,
+    // indices...). It only does the bookkeeping; the owner maps offsets onto GPU memory.
+    // allocate() and free() are O(1): free blocks are binned by size class, found through two
+    // bitmaps, and merged with their physical neighbours when released.
+    //
+    // Block ids returned by allocate() stay valid, and keep referring to the same allocation,
+    // until free(), including across compact().
+    class TlsfAllocator {
+    public:
+        static constexpr uint32_t InvalidBlock = ~0u;
+
+        struct Block {
+            uint32_t offset{0};
+            uint32_t size{0};
+        };
+
+        TlsfAllocator() = default;
+        explicit TlsfAllocator(uint32_t capacity) { init(capacity); }
+
+        void init(uint32_t capacity) {
+            m_nodes.clear();
+            m_spareNodes.clear();
+            m_capacity = capacity;
+            m_used = 0;
+            m_allocations = 0;
+            clearBins();
+
+            m_first = InvalidBlock;
+            if (capacity > 0) {
+                m_first = newNode();
+                m_nodes[m_first].size = capacity;
+                insertFree(m_first);
+            }
+        }
+
+        // Returns InvalidBlock when no free block is large enough.
+        uint32_t allocate(uint32_t size) {
+            if (size == 0) return InvalidBlock;
+
+            uint32_t fl, sl;
+            if (!searchMapping(size, fl, sl)) return InvalidBlock;
+            uint32_t id = findFree(fl, sl);
+            if (id == InvalidBlock) return InvalidBlock;
+
+            removeFree(id);
+            Node& node = m_nodes[id];
+            node.free = false;
+
+            if (node.size > size) {
+                uint32_t rest = newNode();
+                Node& n = m_nodes[id];
+                Node& r = m_nodes[rest];
+                r.offset = n.offset + size;
+                r.size = n.size - size;
+                r.prevPhys = id;
+                r.nextPhys = n.nextPhys;
+                if (n.nextPhys != InvalidBlock) m_nodes[n.nextPhys].prevPhys = rest;
+                n.nextPhys = rest;
+                n.size = size;
+                insertFree(rest);
+            }
+
+            m_used += size;
+            m_allocations++;
+            return id;
+        }
+
+        void free(uint32_t id) {
+            if (id >= m_nodes.size() || m_nodes[id].free || !m_nodes[id].live) return;
+
+            m_used -= m_nodes[id].size;
+            m_allocations--;
+            m_nodes[id].free = true;
+
+            uint32_t next = m_nodes[id].nextPhys;
+            if (next != InvalidBlock && m_nodes[next].free) {
+                removeFree(next);
+                absorb(id, next);
+            }
+
+            uint32_t prev = m_nodes[id].prevPhys;
+            if (prev != InvalidBlock && m_nodes[prev].free) {
+                removeFree(prev);
+                absorb(prev, id);
+                id = prev;
+            }
+
+            insertFree(id);
+        }
+
+        Block block(uint32_t id) const { return {m_nodes[id].offset, m_nodes[id].size}; }
+
+        // Slides every live block down to the start of the range in offset order and leaves one
+        // free block at the end. move(id, oldOffset, newOffset, size) is called for every live
+        // block, including those that stay put, before the allocator records the new offset.
+        template<typename F>
+        void compact(F&& move) {
+            std::vector<uint32_t> live;
+            live.reserve(m_allocations);
+            for (uint32_t id = m_first; id != InvalidBlock;) {
+                uint32_t next = m_nodes[id].nextPhys;
+                if (m_nodes[id].free)
+                    releaseNode(id);
+                else
+                    live.push_back(id);
+                id = next;
+            }
+
+            clearBins();
+            uint32_t offset = 0, prev = InvalidBlock;
+            for (uint32_t id : live) {
+                Node& node = m_nodes[id];
+                move(id, node.offset, offset, node.size);
+                node.offset = offset;
+                node.prevPhys = prev;
+                node.nextPhys = InvalidBlock;
+                if (prev != InvalidBlock) m_nodes[prev].nextPhys = id;
+                prev = id;
+                offset += node.size;
+            }
+
+            m_first = live.empty() ? InvalidBlock : live.front();
+            if (offset < m_capacity) {
+                uint32_t tail = newNode();
+                Node& t = m_nodes[tail];
+                t.offset = offset;
+                t.size = m_capacity - offset;
+                t.prevPhys = prev;
+                if (prev != InvalidBlock) m_nodes[prev].nextPhys = tail;
+                else m_first = tail;
+                insertFree(tail);
+            }
+        }
+
+        uint32_t capacity() const { return m_capacity; }
+        uint32_t used() const { return m_used; }
+        uint32_t available() const { return m_capacity - m_used; }
+        uint32_t allocations() const { return m_allocations; }
+
+        uint32_t freeBlocks() const {
+            uint32_t count = 0;
+            for (uint32_t id = m_first; id != InvalidBlock; id = m_nodes[id].nextPhys)
+                count += m_nodes[id].free ? 1 : 0;
+            return count;
+        }
+
+        // Only the highest non-empty bin can hold the largest block, so this scans one list.
+        uint32_t largestFree() const {
+            if (!m_flBitmap) return 0;
+            uint32_t fl = 31 - static_cast<uint32_t>(std::countl_zero(m_flBitmap));
+            uint32_t sl = 31 - static_cast<uint32_t>(std::countl_zero(m_slBitmap[fl]));
+            uint32_t largest = 0;
+            for (uint32_t id = m_heads[fl][sl]; id != InvalidBlock; id = m_nodes[id].nextFree)
+                largest = std::max(largest, m_nodes[id].size);
+            return largest;
+        }
+
+        // 0 when all free space is one block, approaching 1 as it splinters.
+        float fragmentation() const {
+            uint32_t free = available();
+            return free ? 1.0f - static_cast<float>(largestFree()) / static_cast<float>(free) : 0.0f;
+        }
+
+    private:
+        static constexpr uint32_t SlBits = 4;
+        static constexpr uint32_t SlCount = 1u << SlBits;
+        static constexpr uint32_t FlCount = 32 - SlBits + 1;
+
+        struct Node {
+            uint32_t offset{0};
+            uint32_t size{0};
+            uint32_t prevPhys{InvalidBlock}, nextPhys{InvalidBlock};
+            uint32_t prevFree{InvalidBlock}, nextFree{InvalidBlock};
+            bool free{true};
+            bool live{true};
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_spareNodes;
+        std::array<std::array<uint32_t, SlCount>, FlCount> m_heads{};
+        std::array<uint32_t, FlCount> m_slBitmap{};
+        uint32_t m_flBitmap{0};
+        uint32_t m_first{InvalidBlock};
+        uint32_t m_capacity{0};
+        uint32_t m_used{0};
+        uint32_t m_allocations{0};
+
+        // Sizes below SlCount map linearly into the first row; above that, fl is the power of
+        // two and sl splits it into SlCount equal steps.
+        static void mapping(uint32_t size, uint32_t& fl, uint32_t& sl) {
+            if (size < SlCount) {
+                fl = 0;
+                sl = size;
+                return;
+            }
+            uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+            fl = msb - SlBits + 1;
+            sl = (size >> (msb - SlBits)) & (SlCount - 1);
+        }
+
+        // Rounds up to the next size class so any block in the found bin is large enough.
+        static bool searchMapping(uint32_t size, uint32_t& fl, uint32_t& sl) {
+            uint64_t rounded = size;
+            if (size >= SlCount) {
+                uint32_t msb = static_cast<uint32_t>(std::bit_width(size)) - 1;
+                rounded += (1ull << (msb - SlBits)) - 1;
+            }
+            if (rounded > 0xFFFFFFFFull) return false;
+            mapping(static_cast<uint32_t>(rounded), fl, sl);
+            return true;
+        }
+
+        uint32_t findFree(uint32_t fl, uint32_t sl) const {
+            uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+            if (!slMap) {
+                uint32_t flMap = fl + 1 < 32 ? m_flBitmap & (~0u << (fl + 1)) : 0;
+                if (!flMap) return InvalidBlock;
+                fl = static_cast<uint32_t>(std::countr_zero(flMap));
+                slMap = m_slBitmap[fl];
+            }
+            sl = static_cast<uint32_t>(std::countr_zero(slMap));
+            return m_heads[fl][sl];
+        }
+
+        void insertFree(uint32_t id) {
+            uint32_t fl, sl;
+            mapping(m_nodes[id].size, fl, sl);
+            Node& node = m_nodes[id];
+            node.free = true;
+            node.prevFree = InvalidBlock;
+            node.nextFree = m_heads[fl][sl];
+            if (node.nextFree != InvalidBlock) m_nodes[node.nextFree].prevFree = id;
+            m_heads[fl][sl] = id;
+            m_slBitmap[fl] |= 1u << sl;
+            m_flBitmap |= 1u << fl;
+        }
+
+        void removeFree(uint32_t id) {
+            uint32_t fl, sl;
+            mapping(m_nodes[id].size, fl, sl);
+            Node& node = m_nodes[id];
+            if (node.prevFree != InvalidBlock) m_nodes[node.prevFree].nextFree = node.nextFree;
+            if (node.nextFree != InvalidBlock) m_nodes[node.nextFree].prevFree = node.prevFree;
+            if (m_heads[fl][sl] == id) {
+                m_heads[fl][sl] = node.nextFree;
+                if (node.nextFree == InvalidBlock) {
+                    m_slBitmap[fl] &= ~(1u << sl);
+                    if (!m_slBitmap[fl]) m_flBitmap &= ~(1u << fl);
+                }
+            }
+            node.prevFree = node.nextFree = InvalidBlock;
+        }
+
+        // Merges the physically following block into id and releases its node.
+        void absorb(uint32_t id, uint32_t next) {
+            Node& n = m_nodes[id];
+            n.size += m_nodes[next].size;
+            n.nextPhys = m_nodes[next].nextPhys;
+            if (n.nextPhys != InvalidBlock) m_nodes[n.nextPhys].prevPhys = id;
+            releaseNode(next);
+        }
+
+        uint32_t newNode() {
+            if (!m_spareNodes.empty()) {
+                uint32_t id = m_spareNodes.back();
+                m_spareNodes.pop_back();
+                m_nodes[id] = Node{};
+                return id;
+            }
+            m_nodes.emplace_back();
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        void releaseNode(uint32_t id) {
+            m_nodes[id].live = false;
+            m_spareNodes.push_back(id);
+        }
+
+        void clearBins() {
+            for (auto& row : m_heads) row.fill(InvalidBlock);
+            m_slBitmap.fill(0);
+            m_flBitmap = 0;
+        }
+    };
+
+}
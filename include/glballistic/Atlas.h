@@ -0,0 +1,219 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Texture2DArray.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace gl {
+
+    // Bottom-left skyline packer for one page. The skyline is the upper outline of everything
+    // placed so far, stored as horizontal segments; a rectangle goes where it rests lowest,
+    // preferring the narrowest segment on ties. Space under an overhang is never reused,
+    // which is why batches pack best tallest-first.
+    class SkylinePacker {
+    public:
+        void init(GLsizei width, GLsizei height) {
+            m_width = width;
+            m_height = height;
+            m_used = 0;
+            m_skyline.assign(1, Segment{0, 0, width});
+        }
+
+        bool insert(GLsizei width, GLsizei height, GLint& x, GLint& y) {
+            size_t best = m_skyline.size();
+            GLint bestTop = 0;
+            GLsizei bestWidth = 0;
+
+            for (size_t i = 0; i < m_skyline.size(); i++) {
+                GLint top = fit(i, width, height);
+                if (top < 0) continue;
+                if (best == m_skyline.size() || top + height < bestTop || (top + height == bestTop && m_skyline[i].width < bestWidth)) {
+                    best = i;
+                    bestTop = top + height;
+                    bestWidth = m_skyline[i].width;
+                }
+            }
+
+            if (best == m_skyline.size()) return false;
+
+            x = m_skyline[best].x;
+            y = bestTop - height;
+            place(best, x, bestTop, width);
+            m_used += static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+            return true;
+        }
+
+        float occupancy() const {
+            uint64_t area = static_cast<uint64_t>(m_width) * static_cast<uint64_t>(m_height);
+            return area ? static_cast<float>(m_used) / static_cast<float>(area) : 0.0f;
+        }
+
+        bool empty() const { return m_used == 0; }
+
+    private:
+        struct Segment {
+            GLint x, y;
+            GLsizei width;
+        };
+
+        GLsizei m_width{0}, m_height{0};
+        uint64_t m_used{0};
+        std::vector<Segment> m_skyline;
+
+        // The height a width x height rectangle rests at when its left edge is on segment
+        // index, or -1 when it would stick out of the page.
+        GLint fit(size_t index, GLsizei width, GLsizei height) const {
+            GLint x = m_skyline[index].x;
+            if (x + width > m_width) return -1;
+
+            GLint y = 0;
+            GLsizei remaining = width;
+            for (size_t i = index; remaining > 0; i++) {
+                y = std::max(y, m_skyline[i].y);
+                if (y + height > m_height) return -1;
+                remaining -= m_skyline[i].width;
+            }
+            return y;
+        }
+
+        void place(size_t index, GLint x, GLint top, GLsizei width) {
+            m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(index), Segment{x, top, width});
+
+            // Trim or drop the segments the new one now covers.
+            for (size_t i = index + 1; i < m_skyline.size();) {
+                const Segment& prev = m_skyline[i - 1];
+                GLint overlap = prev.x + prev.width - m_skyline[i].x;
+                if (overlap <= 0) break;
+                if (overlap < m_skyline[i].width) {
+                    m_skyline[i].x += overlap;
+                    m_skyline[i].width -= overlap;
+                    break;
+                }
+                m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+
+            for (size_t i = 0; i + 1 < m_skyline.size();) {
+                if (m_skyline[i].y == m_skyline[i + 1].y) {
+                    m_skyline[i].width += m_skyline[i + 1].width;
+                    m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                } else {
+                    i++;
+                }
+            }
+        }
+    };
+
+    // Where an image ended up: sample layer at UVs in [u0, u1] x [v0, v1]. x, y, width and
+    // height are the same rectangle in texels. An empty region means the atlas was full.
+    struct AtlasRegion {
+        GLfloat u0{0}, v0{0}, u1{0}, v1{0};
+        GLuint layer{0};
+        GLint x{0}, y{0};
+        GLsizei width{0}, height{0};
+
+        explicit operator bool() const { return width > 0; }
+    };
+
+    // Rows of pixels use the same 4-byte alignment as Texture2D::setData.
+    struct AtlasImage {
+        GLsizei width{0}, height{0};
+        const void* pixels{nullptr};
+    };
+
+    // Packs many same-format images into the layers of one Texture2DArray, so everything in
+    // the atlas is drawn with a single texture binding. Each layer has its own SkylinePacker
+    // and new images go to the first layer with room. The layer count is fixed by create().
+    //
+    // padding texels are left free around every image so bilinear filtering of level 0 does
+    // not pick up neighbours; the gap is not filled with edge texels. Placements are not
+    // aligned, so from level 1 down the gap shrinks and texels can straddle two images: with
+    // mipmaps, expect bleeding at coarse levels or clamp sampling to the levels that stay clean.
+    class TextureAtlas {
+    public:
+        void create(GLsizei width, GLsizei height, GLsizei layers, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1, GLsizei padding = 1) {
+            if (m_texture.get()) return;
+            m_texture.create(width, height, layers, internalFormat, format, type, levels);
+            m_padding = padding;
+            m_pages.clear();
+            m_pages.reserve(static_cast<size_t>(layers));
+        }
+
+        void destroy() {
+            m_texture.destroy();
+            m_pages.clear();
+        }
+
+        AtlasRegion add(GLsizei width, GLsizei height, const void* pixels) {
+            GLsizei paddedWidth = width + 2 * m_padding;
+            GLsizei paddedHeight = height + 2 * m_padding;
+            if (width <= 0 || height <= 0 || paddedWidth > m_texture.width() || paddedHeight > m_texture.height()) return {};
+
+            GLint x = 0, y = 0;
+            size_t layer = 0;
+            for (; layer < m_pages.size(); layer++) {
+                if (m_pages[layer].insert(paddedWidth, paddedHeight, x, y)) break;
+            }
+
+            if (layer == m_pages.size()) {
+                if (m_pages.size() == static_cast<size_t>(m_texture.layers())) return {};
+                m_pages.emplace_back().init(m_texture.width(), m_texture.height());
+                if (!m_pages.back().insert(paddedWidth, paddedHeight, x, y)) return {};
+            }
+
+            x += m_padding;
+            y += m_padding;
+            if (pixels)
+                m_texture.setSubData(0, x, y, static_cast<GLint>(layer), width, height, 1, pixels);
+
+            GLfloat w = static_cast<GLfloat>(m_texture.width());
+            GLfloat h = static_cast<GLfloat>(m_texture.height());
+            return {x / w, y / h, (x + width) / w, (y + height) / h, static_cast<GLuint>(layer), x, y, width, height};
+        }
+
+        // Adds a batch tallest-first, which packs a skyline far tighter than arrival order.
+        // Regions come back in the order of images.
+        std::vector<AtlasRegion> add(std::span<const AtlasImage> images) {
+            std::vector<size_t> order(images.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                if (images[a].height != images[b].height) return images[a].height > images[b].height;
+                return images[a].width > images[b].width;
+            });
+
+            std::vector<AtlasRegion> regions(images.size());
+            for (size_t i : order)
+                regions[i] = add(images[i].width, images[i].height, images[i].pixels);
+            return regions;
+        }
+
+        // Forgets every placement; the texture keeps its contents until they are overwritten.
+        void clear() { m_pages.clear(); }
+
+        void bind(GLuint unit = 0) const { m_texture.bind(unit); }
+
+        Texture2DArray& texture() { return m_texture; }
+        const Texture2DArray& texture() const { return m_texture; }
+        GLsizei layersUsed() const { return static_cast<GLsizei>(m_pages.size()); }
+        GLsizei padding() const { return m_padding; }
+
+        // Fraction of the used layers' area covered by padded images.
+        float occupancy() const {
+            if (m_pages.empty()) return 0.0f;
+            float sum = 0.0f;
+            for (const SkylinePacker& page : m_pages)
+                sum += page.occupancy();
+            return sum / static_cast<float>(m_pages.size());
+        }
+
+    private:
+        Texture2DArray m_texture;
+        std::vector<SkylinePacker> m_pages;
+        GLsizei m_padding{1};
+    };
+
+}
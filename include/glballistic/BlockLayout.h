@@ -0,0 +1,297 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/Shader.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace gl {
+
+    enum class BlockPacking { Std140, Std430 };
+
+    template<size_t N>
+    struct FieldName {
+        char value[N]{};
+
+        constexpr FieldName(const char (&str)[N]) { std::copy_n(str, N, value); }
+        constexpr std::string_view view() const { return {value, N - 1}; }
+    };
+
+    // One member of a block. Count > 0 declares an array of that many elements.
+    template<FieldName Name, UniformValue T, size_t Count = 0>
+    struct Field {
+        using Type = T;
+        static constexpr std::string_view name = Name.view();
+        static constexpr size_t count = Count;
+    };
+
+    // Base alignment, size and strides of one member under the std140/std430 rules. Matrices
+    // are laid out as arrays of column vectors.
+    template<BlockPacking Packing, typename T, size_t Count>
+    struct FieldLayout {
+        static constexpr size_t Rows = UniformTraits<T>::Rows;
+        static constexpr size_t Columns = UniformTraits<T>::Columns;
+
+        static constexpr size_t roundUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+        static constexpr size_t vectorSize = Rows * 4;
+        static constexpr size_t vectorAlign = Rows == 1 ? 4 : Rows == 2 ? 8 : 16;
+        static constexpr size_t matrixStride = Columns > 1 ? (Packing == BlockPacking::Std140 ? 16 : vectorAlign) : 0;
+
+        static constexpr size_t elementAlign = Columns > 1 ? matrixStride : vectorAlign;
+        static constexpr size_t elementSize = Columns > 1 ? Columns * matrixStride : vectorSize;
+
+        static constexpr size_t align = Count > 0 && Packing == BlockPacking::Std140 ? roundUp(elementAlign, 16) : elementAlign;
+        static constexpr size_t arrayStride = Count > 0 ? roundUp(elementSize, align) : 0;
+        static constexpr size_t size = Count > 0 ? Count * arrayStride : elementSize;
+    };
+
+    // A block declared as a typed field list; every offset is computed at compile time:
+    //
+    //   using Camera = gl::Block<gl::BlockPacking::Std140,
+    //       gl::Field<"view", float[4][4]>, gl::Field<"position", float[3]>, gl::Field<"time", float>>;
+    //   static_assert(Camera::offset<"time">() == 76);
+    //
+    // Nested structs are not supported; flatten them into the field list.
+    template<BlockPacking Packing, typename... Fields>
+    struct Block {
+        static constexpr BlockPacking packing = Packing;
+        static constexpr size_t fieldCount = sizeof...(Fields);
+
+        template<size_t I>
+        using FieldAt = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+        template<size_t I>
+        using LayoutAt = FieldLayout<Packing, typename FieldAt<I>::Type, FieldAt<I>::count>;
+
+        static constexpr std::array<std::string_view, fieldCount> names{Fields::name...};
+        static constexpr std::array<size_t, fieldCount> aligns{FieldLayout<Packing, typename Fields::Type, Fields::count>::align...};
+        static constexpr std::array<size_t, fieldCount> sizes{FieldLayout<Packing, typename Fields::Type, Fields::count>::size...};
+
+        static constexpr std::array<size_t, fieldCount> offsets = [] {
+            std::array<size_t, fieldCount> result{};
+            size_t offset = 0;
+            for (size_t i = 0; i < fieldCount; i++) {
+                offset = (offset + aligns[i] - 1) / aligns[i] * aligns[i];
+                result[i] = offset;
+                offset += sizes[i];
+            }
+            return result;
+        }();
+
+        static constexpr size_t alignment = [] {
+            size_t result = Packing == BlockPacking::Std140 ? 16 : 4;
+            for (size_t a : aligns) result = std::max(result, a);
+            return result;
+        }();
+
+        static constexpr size_t size = [] {
+            size_t end = fieldCount ? offsets[fieldCount - 1] + sizes[fieldCount - 1] : 0;
+            return (end + alignment - 1) / alignment * alignment;
+        }();
+
+        template<FieldName Name>
+        static constexpr size_t index() {
+            for (size_t i = 0; i < fieldCount; i++) {
+                if (names[i] == Name.view()) return i;
+            }
+            return fieldCount;
+        }
+
+        template<FieldName Name>
+        static constexpr size_t offset() {
+            static_assert(index<Name>() < fieldCount, "no such field in block");
+            return offsets[index<Name>()];
+        }
+    };
+
+    // Writes fields straight into mapped (or otherwise block-sized) memory at their std140/std430
+    // offsets. Source matrices must be tightly packed column-major, as float[C][R] and glm are.
+    template<typename B>
+    class BlockWriter {
+    public:
+        explicit BlockWriter(void* data) : m_data(static_cast<unsigned char*>(data)) {}
+
+        template<FieldName Name, typename T>
+        void set(const T& value, size_t element = 0) const {
+            constexpr size_t I = B::template index<Name>();
+            static_assert(I < B::fieldCount, "no such field in block");
+            using Declared = typename B::template FieldAt<I>;
+            using Layout = typename B::template LayoutAt<I>;
+            static_assert(std::is_same_v<T, typename Declared::Type>, "value type does not match the declared field type");
+
+            unsigned char* dst = m_data + B::offsets[I] + element * Layout::arrayStride;
+            const auto* src = reinterpret_cast<const unsigned char*>(&value);
+            if constexpr (Layout::Columns > 1) {
+                for (size_t c = 0; c < Layout::Columns; c++)
+                    std::memcpy(dst + c * Layout::matrixStride, src + c * Layout::vectorSize, Layout::vectorSize);
+            } else {
+                std::memcpy(dst, src, Layout::vectorSize);
+            }
+        }
+
+        unsigned char* data() const { return m_data; }
+
+    private:
+        unsigned char* m_data;
+    };
+
+    // Many instances of one block in a single buffer, each starting at an offset that is valid
+    // for bindRange() on the given target. With ARB_buffer_storage the buffer stays mapped and
+    // writers go straight to GPU-visible memory; otherwise writes are kept in client memory
+    // and flush() uploads the range touched since the last flush.
+    template<typename B>
+    class BlockBuffer {
+    public:
+        BlockBuffer() = default;
+        ~BlockBuffer() { destroy(); }
+
+        BlockBuffer(const BlockBuffer&) = delete;
+        BlockBuffer& operator=(const BlockBuffer&) = delete;
+
+        void create(GLenum target, size_t count) {
+            if (m_buffer.get()) return;
+
+            m_target = target;
+            m_count = count;
+            GLsizeiptr alignment = BufferOffsetAlignment(target);
+            m_stride = (static_cast<GLsizeiptr>(B::size) + alignment - 1) / alignment * alignment;
+
+            GLsizeiptr total = m_stride * static_cast<GLsizeiptr>(count);
+            m_buffer.create(target);
+            if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                m_buffer.storage(total, nullptr, flags);
+                m_mapped = static_cast<unsigned char*>(m_buffer.mapRange(0, total, flags));
+            } else {
+                m_buffer.data(total, nullptr, GL_DYNAMIC_DRAW);
+                m_staging.assign(static_cast<size_t>(total), 0);
+                m_mapped = m_staging.data();
+            }
+            m_dirtyBegin = count;
+            m_dirtyEnd = 0;
+        }
+
+        void destroy() {
+            if (m_mapped && m_staging.empty())
+                m_buffer.unmap();
+            m_mapped = nullptr;
+            m_staging.clear();
+            m_buffer.destroy();
+            m_count = 0;
+        }
+
+        // The caller must not write an instance the GPU may still be reading; fence or
+        // double-buffer at a higher level (or use StreamBuffer with BlockWriter for per-frame data).
+        BlockWriter<B> operator[](size_t index) {
+            m_dirtyBegin = std::min(m_dirtyBegin, index);
+            m_dirtyEnd = std::max(m_dirtyEnd, index + 1);
+            return BlockWriter<B>(m_mapped + offset(index));
+        }
+
+        void flush() {
+            if (m_dirtyBegin < m_dirtyEnd && !m_staging.empty()) {
+                GLintptr begin = offset(m_dirtyBegin);
+                m_buffer.update(begin, offset(m_dirtyEnd - 1) + static_cast<GLsizeiptr>(B::size) - begin, m_mapped + begin);
+            }
+            m_dirtyBegin = m_count;
+            m_dirtyEnd = 0;
+        }
+
+        void bindRange(GLuint binding, size_t index) const {
+            m_buffer.bindRange(m_target, binding, offset(index), static_cast<GLsizeiptr>(B::size));
+        }
+
+        GLintptr offset(size_t index) const { return static_cast<GLintptr>(index) * m_stride; }
+        GLsizeiptr stride() const { return m_stride; }
+        size_t count() const { return m_count; }
+
+        Buffer& buffer() { return m_buffer; }
+        GLuint get() const { return m_buffer.get(); }
+
+    private:
+        Buffer m_buffer;
+        GLenum m_target{GL_UNIFORM_BUFFER};
+        unsigned char* m_mapped{nullptr};
+        std::vector<unsigned char> m_staging;
+        GLsizeiptr m_stride{0};
+        size_t m_count{0};
+        size_t m_dirtyBegin{0}, m_dirtyEnd{0};
+    };
+
+    // Compares the compile-time layout with what the driver reflects for the linked program.
+    // Offsets in GLSL are only known after linking, so this is a runtime check: call it once
+    // after link() and treat false as a bug. Members are looked up both bare and qualified by
+    // the block name, which is how drivers report blocks that have an instance name.
+    template<typename B>
+    bool ValidateBlock(const Shader& shader, std::string_view blockName, bool storage = false) {
+        const ShaderBlock* block = storage ? shader.findStorageBlock(blockName) : shader.findUniformBlock(blockName);
+        if (!block) {
+            std::cerr << "Block validation: " << blockName << " is not active in program " << shader.get() << std::endl;
+            return false;
+        }
+
+        bool valid = true;
+        if (block->size < static_cast<GLint>(B::size)) {
+            std::cerr << "Block validation: " << blockName << " is " << block->size << " bytes, layout expects " << B::size << std::endl;
+            valid = false;
+        }
+
+        bool interfaceQuery = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_program_interface_query;
+        if (storage && !interfaceQuery) return valid;
+
+        auto check = [&]<size_t I>() {
+            using Layout = typename B::template LayoutAt<I>;
+
+            std::string name(B::names[I]);
+            if (B::template FieldAt<I>::count > 0) name.append("[0]");
+            std::string qualified = std::string(blockName) + "." + name;
+
+            GLint offset = -1, arrayStride = 0, matrixStride = 0;
+            if (interfaceQuery) {
+                GLenum interface = storage ? GL_BUFFER_VARIABLE : GL_UNIFORM;
+                GLuint index = glGetProgramResourceIndex(shader.get(), interface, qualified.c_str());
+                if (index == GL_INVALID_INDEX) index = glGetProgramResourceIndex(shader.get(), interface, name.c_str());
+                if (index == GL_INVALID_INDEX) return;
+                const GLenum props[] = {GL_OFFSET, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE};
+                GLint values[3];
+                glGetProgramResourceiv(shader.get(), interface, index, 3, props, 3, nullptr, values);
+                offset = values[0];
+                arrayStride = values[1];
+                matrixStride = values[2];
+            } else {
+                const ShaderUniform* uniform = shader.findUniform(qualified);
+                if (!uniform) uniform = shader.findUniform(name);
+                if (!uniform) return;
+                offset = uniform->offset;
+                arrayStride = static_cast<GLint>(Layout::arrayStride);
+                matrixStride = static_cast<GLint>(Layout::matrixStride);
+            }
+
+            if (offset != static_cast<GLint>(B::offsets[I]) || arrayStride != static_cast<GLint>(Layout::arrayStride)
+                || matrixStride != static_cast<GLint>(Layout::matrixStride)) {
+                std::cerr << "Block validation: " << blockName << "." << B::names[I] << " is at offset " << offset
+                          << " (array stride " << arrayStride << ", matrix stride " << matrixStride << "), layout expects "
+                          << B::offsets[I] << " (" << Layout::arrayStride << ", " << Layout::matrixStride << ")" << std::endl;
+                valid = false;
+            }
+        };
+
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (check.template operator()<I>(), ...);
+        }(std::make_index_sequence<B::fieldCount>{});
+
+        return valid;
+    }
+
+}
\ No newline at end of file
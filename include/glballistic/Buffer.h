@@ -20,9 +20,13 @@ namespace gl {
                 m_id = other.m_id;
                 m_size = other.m_size;
                 m_target = other.m_target;
+                m_storageFlags = other.m_storageFlags;
+                m_immutable = other.m_immutable;
                 other.m_id = 0;
                 other.m_size = 0;
                 other.m_target = 0;
+                other.m_storageFlags = 0;
+                other.m_immutable = false;
             }
             return *this;
         }
@@ -30,18 +34,18 @@ namespace gl {
         void create(GLenum target) {
             if (m_id) return;
             m_target = target;
-            if (GLAD_GL_VERSION_4_5)
-                glCreateBuffers(1, &m_id);
-            else
-                glGenBuffers(1, &m_id);
+            m_id = State::names().buffers.acquire();
         }
 
         void destroy() {
             if (!m_id) return;
+            State::forgetBuffer(m_id);
             glDeleteBuffers(1, &m_id);
             m_id = 0;
             m_size = 0;
             m_target = 0;
+            m_storageFlags = 0;
+            m_immutable = false;
         }
 
         bool valid() const { return m_id != 0 && glIsBuffer(m_id); }
@@ -50,11 +54,15 @@ namespace gl {
         void bind() const { State::bindBuffer(m_target, m_id); }
         void unbind() const { State::bindBuffer(m_target, 0); }
 
-        void bindBase(GLenum target, GLuint index) const { glBindBufferBase(target, index, m_id); }
-        void bindRange(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size) const { glBindBufferRange(target, index, m_id, offset, size); }
+        // access only matters for GL_SHADER_STORAGE_BUFFER: GL_READ_ONLY tells hazard tracking
+        // that shaders do not write the buffer through this binding.
+        void bindBase(GLenum target, GLuint index, GLenum access = GL_READ_WRITE) const { State::bindBufferBase(target, index, m_id, access); }
+        void bindRange(GLenum target, GLuint index, GLintptr offset, GLsizeiptr size, GLenum access = GL_READ_WRITE) const { State::bindBufferRange(target, index, m_id, offset, size, access); }
 
         void data(GLsizeiptr size, const void* data, GLenum usage) {
             m_size = size;
+            State::hazards().forget(HazardResource::Buffer, m_id);
+            if (data) GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(size)));
             if (GLAD_GL_VERSION_4_5)
                 glNamedBufferData(m_id, size, data, usage);
             else {
@@ -64,6 +72,8 @@ namespace gl {
         }
 
         void update(GLintptr offset, GLsizeiptr size, const void* data) {
+            State::syncBuffer(m_id, "Buffer::update");
+            GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(size)));
             if (GLAD_GL_VERSION_4_5)
                 glNamedBufferSubData(m_id, offset, size, data);
             else {
@@ -73,6 +83,10 @@ namespace gl {
         }
 
         void storage(GLsizeiptr size, const void* data, GLbitfield flags) {
+            m_size = size;
+            m_storageFlags = flags;
+            m_immutable = true;
+            if (data) GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(size)));
             if (GLAD_GL_VERSION_4_5)
                 glNamedBufferStorage(m_id, size, data, flags);
             else {
@@ -82,6 +96,8 @@ namespace gl {
         }
 
         void clear(GLenum internalFormat, GLenum format, GLenum type, const void* data) {
+            State::syncBuffer(m_id, "Buffer::clear");
+            GLBALLISTIC_STAT(State::countClear());
             if (GLAD_GL_VERSION_4_5)
                 glClearNamedBufferData(m_id, internalFormat, format, type, data);
             else {
@@ -91,6 +107,8 @@ namespace gl {
         }
 
         void clearRange(GLenum internalFormat, GLintptr offset, GLsizeiptr size, GLenum format, GLenum type, const void* data) {
+            State::syncBuffer(m_id, "Buffer::clearRange");
+            GLBALLISTIC_STAT(State::countClear());
             if (GLAD_GL_VERSION_4_5)
                 glClearNamedBufferSubData(m_id, internalFormat, offset, size, format, type, data);
             else {
@@ -100,13 +118,23 @@ namespace gl {
         }
         
         void copy(const Buffer& src, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+            State::syncBuffer(src.m_id, "Buffer::copy");
+            State::syncBuffer(m_id, "Buffer::copy");
+            GLBALLISTIC_STAT(State::countCopy(static_cast<uint64_t>(size)));
             if (GLAD_GL_VERSION_4_5)
                 glCopyNamedBufferSubData(src.m_id, m_id, readOffset, writeOffset, size);
-            else
-                glCopyBufferSubData(src.m_target, m_target, readOffset, writeOffset, size);
+            else {
+                // The copy targets are bound to nothing else, so neither the bound VAO's
+                // element buffer nor any other binding is disturbed.
+                State::bindBuffer(GL_COPY_READ_BUFFER, src.m_id);
+                State::bindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, readOffset, writeOffset, size);
+            }
         }
 
         void* map(GLenum access) {
+            State::syncBuffer(m_id, "Buffer::map");
+            GLBALLISTIC_STAT(State::countMap());
             if (GLAD_GL_VERSION_4_5) 
                 return glMapNamedBuffer(m_id, access);
             bind();
@@ -114,6 +142,8 @@ namespace gl {
         }
 
         void* mapRange(GLintptr offset, GLsizeiptr length, GLbitfield access) {
+            State::syncBuffer(m_id, "Buffer::mapRange");
+            GLBALLISTIC_STAT(State::countMap());
             if (GLAD_GL_VERSION_4_5)
                 return glMapNamedBufferRange(m_id, offset, length, access);
             bind();
@@ -166,11 +196,15 @@ namespace gl {
         
         GLsizeiptr size() const { return m_size; }
         GLenum target() const { return m_target; }
+        GLbitfield storageFlags() const { return m_storageFlags; }
+        bool immutable() const { return m_immutable; }
 
     private:
         GLuint m_id{0};
         GLsizeiptr m_size{0};
         GLenum m_target{0};
+        GLbitfield m_storageFlags{0};
+        bool m_immutable{false};
     };
 
 }
\ No newline at end of file
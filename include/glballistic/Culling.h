@@ -0,0 +1,286 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/IndirectCommandBuffer.h>
+#include <glballistic/Shader.h>
+#include <glballistic/Texture2D.h>
+#include <glballistic/VertexArray.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace gl {
+
+    // std430 element of the instance buffer read by CullingPass. sphere is the object-space
+    // bounding sphere (xyz center, w radius); the remaining fields describe the mesh draw and
+    // are copied into the emitted DrawElementsIndirectCommand.
+    struct CullInstance {
+        GLfloat model[4][4]{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+        GLfloat sphere[4]{0, 0, 0, 0};
+        GLuint indexCount{0};
+        GLuint firstIndex{0};
+        GLint baseVertex{0};
+        GLuint pad{0};
+    };
+
+    static_assert(sizeof(CullInstance) == 96);
+
+    // Normalized planes (xyz normal, w distance) of a column-major view-projection matrix in
+    // left, right, bottom, top, near, far order; a point is inside when dot(n, p) + w >= 0.
+    inline void ExtractFrustumPlanes(const GLfloat viewProj[4][4], GLfloat planes[6][4]) {
+        for (int i = 0; i < 6; i++) {
+            int row = i / 2;
+            float sign = (i % 2) ? -1.0f : 1.0f;
+            for (int c = 0; c < 4; c++)
+                planes[i][c] = viewProj[c][3] + sign * viewProj[c][row];
+
+            float length = std::sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+            if (length > 0.0f)
+                for (int c = 0; c < 4; c++) planes[i][c] /= length;
+        }
+    }
+
+    // GPU visibility for instanced geometry sharing one vertex/index buffer. cull() tests every
+    // CullInstance against the frustum, and optionally against a max-depth pyramid built from
+    // last frame's depth buffer, then appends one DrawElementsIndirectCommand per survivor and
+    // bumps a GPU-side counter. draw() submits them with multiDrawElementsIndirectCount, so no
+    // visibility result ever comes back to the CPU.
+    //
+    // Each emitted command has instanceCount 1 and baseInstance set to the instance's index in
+    // the input buffer; vertex shaders fetch the transform with gl_BaseInstance or through a
+    // per-instance attribute. Needs GL 4.3 for compute shaders and storage buffers.
+    class CullingPass {
+    public:
+        static constexpr GLuint InstanceBinding = 0;
+        static constexpr GLuint CommandBinding = 1;
+        static constexpr GLuint CountBinding = 2;
+        static constexpr GLuint GroupSize = 64;
+
+        CullingPass() = default;
+
+        CullingPass(const CullingPass&) = delete;
+        CullingPass& operator=(const CullingPass&) = delete;
+
+        void create(GLuint maxInstances) {
+            if (m_commands.get()) return;
+            m_maxInstances = maxInstances;
+
+            m_commands.create(GL_DRAW_INDIRECT_BUFFER);
+            m_commands.storage(static_cast<GLsizeiptr>(maxInstances) * sizeof(DrawElementsIndirectCommand), nullptr, 0);
+            m_count.create(GL_PARAMETER_BUFFER);
+            m_count.storage(sizeof(GLuint), nullptr, 0);
+
+            m_cull.create();
+            m_cull.attachShader(GL_COMPUTE_SHADER, CullSource);
+            m_cull.link();
+
+            m_reduce.create();
+            m_reduce.attachShader(GL_COMPUTE_SHADER, ReduceSource);
+            m_reduce.link();
+        }
+
+        void destroy() {
+            m_commands.destroy();
+            m_count.destroy();
+            m_pyramid.destroy();
+            m_cull.destroy();
+            m_reduce.destroy();
+            m_maxInstances = 0;
+        }
+
+        // Rebuilds the max-depth pyramid from a depth texture (typically the previous frame's).
+        // Until this has been called once, cull() tests against the frustum only.
+        void buildDepthPyramid(const Texture2D& depth) {
+            GLBALLISTIC_PROFILE_ZONE("CullingPass::buildDepthPyramid");
+            if (m_pyramid.width() != depth.width() || m_pyramid.height() != depth.height() || !m_pyramid.get()) {
+                m_pyramid.destroy();
+                GLsizei levels = 1 + static_cast<GLsizei>(std::floor(std::log2(static_cast<float>(std::max(depth.width(), depth.height())))));
+                m_pyramid.create(depth.width(), depth.height(), GL_R32F, GL_RED, GL_FLOAT, levels);
+                m_pyramid.setParameters(GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE);
+            }
+
+            for (GLint level = 0; level < m_pyramid.levels(); level++) {
+                if (level == 0)
+                    depth.bind(0);
+                else
+                    m_pyramid.bindImage(0, GL_READ_ONLY, level - 1);
+                m_pyramid.bindImage(1, GL_WRITE_ONLY, level);
+
+                m_reduce.setUniform(UniformName("u_level"), static_cast<GLint>(level));
+                m_reduce.dispatchCompute(groups(m_pyramid.levelWidth(level), 8), groups(m_pyramid.levelHeight(level), 8), 1,
+                                         GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+            }
+            m_hasPyramid = true;
+        }
+
+        void invalidateDepthPyramid() { m_hasPyramid = false; }
+
+        // viewProj must be the matrix the depth pyramid was rendered with when occlusion is used.
+        void cull(const Buffer& instances, GLuint instanceCount, const GLfloat (&viewProj)[4][4], bool occlusion = true) {
+            GLBALLISTIC_PROFILE_ZONE("CullingPass::cull");
+            instanceCount = std::min(instanceCount, m_maxInstances);
+
+            GLuint zero = 0;
+            m_count.clear(GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+            GLfloat planes[6][4];
+            ExtractFrustumPlanes(viewProj, planes);
+
+            bool hiZ = occlusion && m_hasPyramid;
+            m_cull.setUniform(UniformName("u_viewProj"), viewProj);
+            m_cull.setUniform(UniformName("u_planes"), std::span<const GLfloat[4]>(planes, 6));
+            m_cull.setUniform(UniformName("u_instanceCount"), instanceCount);
+            m_cull.setUniform(UniformName("u_occlusion"), static_cast<GLint>(hiZ));
+            if (hiZ) {
+                GLfloat size[2] = {static_cast<GLfloat>(m_pyramid.width()), static_cast<GLfloat>(m_pyramid.height())};
+                m_cull.setUniform(UniformName("u_pyramidSize"), size);
+                m_cull.setUniform(UniformName("u_pyramidLevels"), static_cast<GLint>(m_pyramid.levels()));
+                m_pyramid.bind(0);
+            }
+
+            instances.bindBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, GL_READ_ONLY);
+            m_commands.bindBase(GL_SHADER_STORAGE_BUFFER, CommandBinding);
+            m_count.bindBase(GL_SHADER_STORAGE_BUFFER, CountBinding);
+
+            // Without indirect-count draws, draw() reads the count back on the CPU, which needs
+            // the buffer-update barrier as well.
+            GLbitfield barriers = GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT;
+            if (!VertexArray::hasIndirectCount())
+                barriers |= GL_BUFFER_UPDATE_BARRIER_BIT;
+            m_cull.dispatchCompute(groups(static_cast<GLsizei>(instanceCount), GroupSize), 1, 1, barriers);
+        }
+
+        // Draws the survivors of the last cull() with the index type and buffers of vao.
+        void draw(const VertexArray& vao, GLenum mode = GL_TRIANGLES) const {
+            vao.multiDrawElementsIndirectCount(mode, m_commands, 0, m_count, 0, static_cast<GLsizei>(m_maxInstances));
+        }
+
+        const Buffer& commands() const { return m_commands; }
+        const Buffer& drawCount() const { return m_count; }
+        const Texture2D& depthPyramid() const { return m_pyramid; }
+        GLuint maxInstances() const { return m_maxInstances; }
+
+    private:
+        Buffer m_commands;
+        Buffer m_count;
+        Texture2D m_pyramid;
+        Shader m_cull;
+        Shader m_reduce;
+        GLuint m_maxInstances{0};
+        bool m_hasPyramid{false};
+
+        static GLuint groups(GLsizei count, GLuint size) { return (static_cast<GLuint>(std::max(count, 1)) + size - 1) / size; }
+
+        // Each texel of a level is the farthest depth of the texels it covers in the level
+        // above; odd source sizes fold the extra row/column into the last texel.
+        static constexpr const char* ReduceSource = R"(
+            #version 430 core
+            layout(local_size_x = 8, local_size_y = 8) in;
+
+            layout(binding = 0) uniform sampler2D u_depth;
+            layout(r32f, binding = 0) readonly uniform image2D u_src;
+            layout(r32f, binding = 1) writeonly uniform image2D u_dst;
+            uniform int u_level;
+
+            float fetch(ivec2 p, ivec2 size) {
+                p = min(p, size - 1);
+                return u_level == 0 ? texelFetch(u_depth, p, 0).r : imageLoad(u_src, p).r;
+            }
+
+            void main() {
+                ivec2 dst = ivec2(gl_GlobalInvocationID.xy);
+                ivec2 dstSize = imageSize(u_dst);
+                if (any(greaterThanEqual(dst, dstSize))) return;
+
+                if (u_level == 0) {
+                    imageStore(u_dst, dst, vec4(texelFetch(u_depth, dst, 0).r));
+                    return;
+                }
+
+                ivec2 srcSize = imageSize(u_src);
+                ivec2 src = dst * 2;
+                ivec2 extent = ivec2(2) + ivec2(equal(dst, dstSize - 1)) * (srcSize & 1);
+
+                float depth = 0.0;
+                for (int y = 0; y < extent.y; y++)
+                    for (int x = 0; x < extent.x; x++)
+                        depth = max(depth, fetch(src + ivec2(x, y), srcSize));
+                imageStore(u_dst, dst, vec4(depth));
+            }
+        )";
+
+        static constexpr const char* CullSource = R"(
+            #version 430 core
+            layout(local_size_x = 64) in;
+
+            struct Instance {
+                mat4 model;
+                vec4 sphere;
+                uint indexCount;
+                uint firstIndex;
+                int baseVertex;
+                uint pad;
+            };
+
+            layout(std430, binding = 0) readonly buffer Instances { Instance instances[]; };
+            layout(std430, binding = 1) writeonly buffer Commands { uint commands[]; };
+            layout(std430, binding = 2) buffer DrawCount { uint drawCount; };
+
+            layout(binding = 0) uniform sampler2D u_pyramid;
+            uniform mat4 u_viewProj;
+            uniform vec4 u_planes[6];
+            uniform uint u_instanceCount;
+            uniform int u_occlusion;
+            uniform vec2 u_pyramidSize;
+            uniform int u_pyramidLevels;
+
+            bool occluded(vec3 center, float radius) {
+                vec2 lo = vec2(1.0), hi = vec2(0.0);
+                float nearest = 1.0;
+                for (int i = 0; i < 8; i++) {
+                    vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+                    vec4 clip = u_viewProj * vec4(corner, 1.0);
+                    if (clip.w <= 0.0) return false;
+                    vec3 ndc = clip.xyz / clip.w;
+                    vec2 uv = ndc.xy * 0.5 + 0.5;
+                    lo = min(lo, uv);
+                    hi = max(hi, uv);
+                    nearest = min(nearest, ndc.z * 0.5 + 0.5);
+                }
+
+                lo = clamp(lo, 0.0, 1.0);
+                hi = clamp(hi, 0.0, 1.0);
+                vec2 extent = (hi - lo) * u_pyramidSize;
+                float level = clamp(ceil(log2(max(max(extent.x, extent.y), 1.0))), 0.0, float(u_pyramidLevels - 1));
+
+                float farthest = max(max(textureLod(u_pyramid, lo, level).r, textureLod(u_pyramid, vec2(hi.x, lo.y), level).r),
+                                     max(textureLod(u_pyramid, vec2(lo.x, hi.y), level).r, textureLod(u_pyramid, hi, level).r));
+                return nearest > farthest;
+            }
+
+            void main() {
+                uint index = gl_GlobalInvocationID.x;
+                if (index >= u_instanceCount) return;
+
+                Instance inst = instances[index];
+                vec3 center = (inst.model * vec4(inst.sphere.xyz, 1.0)).xyz;
+                float scale = max(max(length(inst.model[0].xyz), length(inst.model[1].xyz)), length(inst.model[2].xyz));
+                float radius = inst.sphere.w * scale;
+
+                for (int i = 0; i < 6; i++)
+                    if (dot(u_planes[i].xyz, center) + u_planes[i].w < -radius) return;
+
+                if (u_occlusion != 0 && occluded(center, radius)) return;
+
+                uint slot = atomicAdd(drawCount, 1u);
+                commands[slot * 5u + 0u] = inst.indexCount;
+                commands[slot * 5u + 1u] = 1u;
+                commands[slot * 5u + 2u] = inst.firstIndex;
+                commands[slot * 5u + 3u] = uint(inst.baseVertex);
+                commands[slot * 5u + 4u] = index;
+            }
+        )";
+    };
+
+}
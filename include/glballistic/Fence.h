@@ -0,0 +1,156 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace gl {
+
+    // A fence that was never created counts as signaled, so owners can poll or wait
+    // unconditionally. The first client wait (or poll) flushes the command stream; after
+    // that, polling only reads GL_SYNC_STATUS and never stalls.
+    class Fence {
+    public:
+        Fence() = default;
+        ~Fence() { destroy(); }
+
+        Fence(const Fence&) = delete;
+        Fence& operator=(const Fence&) = delete;
+
+        Fence(Fence&& other) noexcept { *this = std::move(other); }
+        Fence& operator=(Fence&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                m_sync = other.m_sync;
+                m_flushed = other.m_flushed;
+                m_signaled = other.m_signaled;
+                other.m_sync = nullptr;
+                other.m_flushed = false;
+                other.m_signaled = false;
+            }
+            return *this;
+        }
+
+        // Pass flush = true when another context is going to waitServer() on this fence;
+        // the sync object only becomes visible to it once the creating context has flushed.
+        void create(bool flush = false) {
+            destroy();
+            m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            if (flush) {
+                glFlush();
+                m_flushed = true;
+            }
+        }
+
+        void destroy() {
+            if (!m_sync) return;
+            glDeleteSync(m_sync);
+            m_sync = nullptr;
+            m_flushed = false;
+            m_signaled = false;
+        }
+
+        bool valid() const { return m_sync != nullptr; }
+        GLsync get() const { return m_sync; }
+
+        bool signaled() {
+            if (!m_sync || m_signaled) return true;
+            if (!m_flushed) return wait(0);
+
+            GLint status = GL_UNSIGNALED;
+            glGetSynciv(m_sync, GL_SYNC_STATUS, 1, nullptr, &status);
+            m_signaled = status == GL_SIGNALED;
+            return m_signaled;
+        }
+
+        // Blocks for at most timeout nanoseconds. A failed wait is reported as signaled so
+        // callers that loop on it cannot spin forever.
+        bool wait(GLuint64 timeout = GL_TIMEOUT_IGNORED) {
+            if (!m_sync || m_signaled) return true;
+
+            GLenum status = glClientWaitSync(m_sync, m_flushed ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            m_flushed = true;
+            m_signaled = status != GL_TIMEOUT_EXPIRED;
+            return m_signaled;
+        }
+
+        // Makes the server (the GL command stream of the current context) wait, without
+        // blocking the calling thread.
+        void waitServer() const {
+            if (m_sync && !m_signaled)
+                glWaitSync(m_sync, 0, GL_TIMEOUT_IGNORED);
+        }
+
+    private:
+        GLsync m_sync{nullptr};
+        bool m_flushed{false};
+        bool m_signaled{false};
+    };
+
+    // Monotonic serial counter backed by a queue of fences. signal() returns the serial of the
+    // work submitted so far; completed() retires signaled fences without blocking.
+    class Timeline {
+    public:
+        Timeline() = default;
+
+        Timeline(const Timeline&) = delete;
+        Timeline& operator=(const Timeline&) = delete;
+        Timeline(Timeline&&) noexcept = default;
+        Timeline& operator=(Timeline&&) noexcept = default;
+
+        uint64_t signal(bool flush = false) {
+            m_pending.emplace_back();
+            m_pending.back().first = ++m_signaled;
+            m_pending.back().second.create(flush);
+            return m_signaled;
+        }
+
+        uint64_t completed() {
+            while (!m_pending.empty() && m_pending.front().second.signaled()) {
+                m_completed = m_pending.front().first;
+                m_pending.pop_front();
+            }
+            return m_completed;
+        }
+
+        bool reached(uint64_t serial) { return serial <= m_completed || serial <= completed(); }
+
+        // Fences retire in submission order, so only the newest one covering serial is waited on.
+        bool wait(uint64_t serial, GLuint64 timeout = GL_TIMEOUT_IGNORED) {
+            size_t count = 0;
+            while (count < m_pending.size() && m_pending[count].first <= serial) count++;
+            if (count == 0) return serial <= m_completed;
+
+            if (!m_pending[count - 1].second.wait(timeout)) return false;
+            m_completed = m_pending[count - 1].first;
+            m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(count));
+            return true;
+        }
+
+        // Server-side wait for the given serial on the current context.
+        void waitServer(uint64_t serial) const {
+            for (const auto& [value, fence] : m_pending) {
+                if (value >= serial) {
+                    fence.waitServer();
+                    return;
+                }
+            }
+        }
+
+        uint64_t lastSignaled() const { return m_signaled; }
+        uint64_t lastCompleted() const { return m_completed; }
+        size_t pending() const { return m_pending.size(); }
+
+        void clear() {
+            m_pending.clear();
+            m_completed = m_signaled;
+        }
+
+    private:
+        std::deque<std::pair<uint64_t, Fence>> m_pending;
+        uint64_t m_signaled{0};
+        uint64_t m_completed{0};
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,471 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Profiler.h>
+#include <glballistic/Texture2D.h>
+#include <glballistic/Framebuffer.h>
+#include <glballistic/Pool.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    struct FrameResource {
+        uint32_t id{~0u};
+
+        explicit operator bool() const { return id != ~0u; }
+        bool operator==(const FrameResource&) const = default;
+    };
+
+    struct TextureDesc {
+        GLsizei width{0}, height{0};
+        GLenum internalFormat{GL_RGBA8}, format{GL_RGBA}, type{GL_UNSIGNED_BYTE};
+        GLsizei levels{1};
+
+        bool operator==(const TextureDesc&) const = default;
+    };
+
+    // How a pass touches a texture. Writes through attachments are ordered by GL itself;
+    // image stores are not, and are what the graph places memory barriers after.
+    enum class Access : uint8_t {
+        Sampled,
+        ImageRead,
+        ImageWrite,
+        ColorAttachment,
+        DepthAttachment
+    };
+
+    struct FrameGraphStats {
+        uint32_t passes{0};
+        uint32_t culledPasses{0};
+        uint32_t transientTextures{0};
+        uint32_t physicalTextures{0};
+        uint32_t barriers{0};
+        uint32_t invalidations{0};
+    };
+
+    class FrameGraph;
+
+    // Handed to a pass's execute callback. The pass's framebuffer, when it writes any
+    // attachment, is already bound with the viewport covering its first attachment.
+    class PassContext {
+    public:
+        Texture2D& texture(FrameResource resource) const;
+        Framebuffer* framebuffer() const { return m_framebuffer; }
+        const std::string& name() const { return m_name; }
+
+    private:
+        friend class FrameGraph;
+        PassContext(FrameGraph& graph, Framebuffer* framebuffer, const std::string& name) : m_graph(graph), m_framebuffer(framebuffer), m_name(name) {}
+
+        FrameGraph& m_graph;
+        Framebuffer* m_framebuffer;
+        const std::string& m_name;
+    };
+
+    // Per-frame render graph over textures. Passes declare what they create, read and write
+    // during setup; compile() then
+    //   - culls passes whose results nothing consumes (imported textures and passes marked
+    //     with sideEffect() are the roots),
+    //   - computes each transient texture's first and last use among the surviving passes,
+    //   - assigns transients with equal descriptions and disjoint lifetimes to the same
+    //     physical texture, which is drawn from a TexturePool that persists across frames,
+    //   - records, per pass, the glMemoryBarrier bits needed after earlier image stores and
+    //     which textures can be invalidated because their previous contents are dead.
+    // execute() runs the surviving passes in declaration order, which is always a valid order
+    // since a pass can only use resources declared before it.
+    //
+    // Typical frame: reset(), importTexture()/addPass() ..., compile(), execute().
+    class FrameGraph {
+    public:
+        class Builder {
+        public:
+            // Declares a transient texture; the pass that fills it still calls write().
+            FrameResource create(const std::string& name, const TextureDesc& desc) { return m_graph.addResource(name, desc, nullptr); }
+
+            FrameResource read(FrameResource resource, Access access = Access::Sampled) {
+                m_graph.m_passes[m_pass].reads.push_back({resource.id, access});
+                return resource;
+            }
+
+            FrameResource write(FrameResource resource, Access access = Access::ColorAttachment) {
+                m_graph.m_passes[m_pass].writes.push_back({resource.id, access});
+                m_graph.m_resources[resource.id].writers.push_back(m_pass);
+                return resource;
+            }
+
+            // Keeps the pass even if nothing reads what it writes (e.g. it presents or reads back).
+            void sideEffect() { m_graph.m_passes[m_pass].sideEffect = true; }
+
+        private:
+            friend class FrameGraph;
+            Builder(FrameGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+            FrameGraph& m_graph;
+            uint32_t m_pass;
+        };
+
+        FrameGraph() = default;
+
+        FrameGraph(const FrameGraph&) = delete;
+        FrameGraph& operator=(const FrameGraph&) = delete;
+
+        // An externally owned texture. It is never aliased, and passes writing it are never culled.
+        FrameResource importTexture(const std::string& name, Texture2D& texture) {
+            TextureDesc desc{texture.width(), texture.height(), texture.internalFormat(), texture.format(), texture.type(), texture.levels()};
+            return addResource(name, desc, &texture);
+        }
+
+        template<typename Setup, typename Execute>
+        void addPass(const std::string& name, Setup&& setup, Execute&& execute) {
+            uint32_t index = static_cast<uint32_t>(m_passes.size());
+            m_passes.emplace_back();
+            m_passes.back().name = name;
+            m_passes.back().execute = std::forward<Execute>(execute);
+
+            Builder builder(*this, index);
+            setup(builder);
+        }
+
+        void compile() {
+            GLBALLISTIC_PROFILE_ZONE("FrameGraph::compile");
+            m_stats = FrameGraphStats{};
+            m_stats.passes = static_cast<uint32_t>(m_passes.size());
+
+            cull();
+            computeLifetimes();
+            assignPhysical();
+            planBarriers();
+            m_compiled = true;
+        }
+
+        void execute() {
+            GLBALLISTIC_PROFILE_ZONE("FrameGraph::execute");
+            if (!m_compiled) compile();
+
+            for (Physical& p : m_physical) {
+                if (!p.imported)
+                    p.owned = std::make_unique<Texture2D>(m_pool.acquire(p.desc.width, p.desc.height, p.desc.internalFormat, p.desc.format, p.desc.type, p.desc.levels));
+            }
+
+            if (m_framebuffers.size() < m_passes.size())
+                m_framebuffers.resize(m_passes.size());
+
+            for (uint32_t i = 0; i < m_passes.size(); i++) {
+                Pass& pass = m_passes[i];
+                if (pass.culled) continue;
+
+                bool debugGroup = GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug;
+                if (debugGroup) glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, i, -1, pass.name.c_str());
+
+                State::memoryBarrier(pass.barriers);
+                if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_invalidate_subdata) {
+                    for (uint32_t r : pass.invalidate)
+                        glInvalidateTexImage(physicalTexture(r).get(), 0);
+                }
+
+                Framebuffer* fb = bindTargets(i);
+                PassContext context(*this, fb, pass.name);
+                pass.execute(context);
+
+                if (debugGroup) glPopDebugGroup();
+            }
+
+            // The cached framebuffers outlive this frame's textures; don't leave them pointing at
+            // objects that are about to be moved into the pool.
+            for (Framebuffer& fb : m_framebuffers)
+                fb.forgetAttachments();
+
+            for (Physical& p : m_physical) {
+                if (p.owned) m_pool.release(std::move(*p.owned));
+                p.owned.reset();
+            }
+            m_pool.nextFrame();
+        }
+
+        // Drops this frame's passes and resources. Pooled textures and pass framebuffers are kept.
+        void reset() {
+            m_passes.clear();
+            m_resources.clear();
+            m_physical.clear();
+            m_compiled = false;
+        }
+
+        // Deletes pooled textures and cached framebuffers as well.
+        void clear() {
+            reset();
+            m_pool.clear();
+            m_framebuffers.clear();
+            m_framebufferLayouts.clear();
+        }
+
+        bool culled(const std::string& passName) const {
+            for (const Pass& pass : m_passes)
+                if (pass.name == passName) return pass.culled;
+            return false;
+        }
+
+        // Physical texture index a resource was assigned, or ~0u if no surviving pass uses it.
+        uint32_t physicalIndex(FrameResource resource) const { return m_resources[resource.id].physical; }
+
+        const FrameGraphStats& stats() const { return m_stats; }
+        const PoolStats& poolStats() const { return m_pool.stats(); }
+
+    private:
+        friend class PassContext;
+        static constexpr uint32_t None = ~0u;
+
+        struct Use {
+            uint32_t resource;
+            Access access;
+        };
+
+        struct Pass {
+            std::string name;
+            std::function<void(PassContext&)> execute;
+            std::vector<Use> reads;
+            std::vector<Use> writes;
+            std::vector<uint32_t> invalidate;
+            GLbitfield barriers{0};
+            bool sideEffect{false};
+            bool culled{false};
+        };
+
+        struct Resource {
+            std::string name;
+            TextureDesc desc;
+            Texture2D* imported{nullptr};
+            std::vector<uint32_t> writers;
+            uint32_t first{None}, last{None};
+            uint32_t physical{None};
+        };
+
+        struct Physical {
+            TextureDesc desc;
+            Texture2D* imported{nullptr};
+            std::unique_ptr<Texture2D> owned;
+            uint32_t lastUse{None};
+        };
+
+        std::vector<Pass> m_passes;
+        std::vector<Resource> m_resources;
+        std::vector<Physical> m_physical;
+        std::vector<Framebuffer> m_framebuffers;
+        std::vector<GLuint> m_framebufferLayouts;
+        TexturePool m_pool;
+        FrameGraphStats m_stats;
+        bool m_compiled{false};
+
+        FrameResource addResource(const std::string& name, const TextureDesc& desc, Texture2D* imported) {
+            Resource r;
+            r.name = name;
+            r.desc = desc;
+            r.imported = imported;
+            m_resources.push_back(std::move(r));
+            m_compiled = false;
+            return {static_cast<uint32_t>(m_resources.size() - 1)};
+        }
+
+        // Walks back from the roots: a resource is needed if it is imported or read by a live
+        // pass, and a pass is live if it has a side effect or writes a needed resource. A
+        // pass's own reads therefore only matter once something else keeps it alive, so a
+        // read-modify-write pass nobody consumes is culled along with its producers.
+        void cull() {
+            std::vector<bool> live(m_passes.size(), false);
+            std::vector<bool> needed(m_resources.size(), false);
+            std::vector<uint32_t> pending;
+
+            auto need = [&](uint32_t id) {
+                if (!needed[id]) {
+                    needed[id] = true;
+                    pending.push_back(id);
+                }
+            };
+            auto keep = [&](uint32_t index) {
+                if (live[index]) return;
+                live[index] = true;
+                for (const Use& use : m_passes[index].reads)
+                    need(use.resource);
+            };
+
+            for (uint32_t i = 0; i < m_resources.size(); i++)
+                if (m_resources[i].imported) need(i);
+            for (uint32_t i = 0; i < m_passes.size(); i++)
+                if (m_passes[i].sideEffect) keep(i);
+
+            while (!pending.empty()) {
+                uint32_t id = pending.back();
+                pending.pop_back();
+                for (uint32_t writer : m_resources[id].writers)
+                    keep(writer);
+            }
+
+            for (uint32_t i = 0; i < m_passes.size(); i++) {
+                m_passes[i].culled = !live[i];
+                if (!live[i]) m_stats.culledPasses++;
+            }
+        }
+
+        void computeLifetimes() {
+            for (Resource& r : m_resources) {
+                r.first = r.last = None;
+                r.physical = None;
+            }
+
+            for (uint32_t i = 0; i < m_passes.size(); i++) {
+                if (m_passes[i].culled) continue;
+                auto touch = [&](const Use& use) {
+                    Resource& r = m_resources[use.resource];
+                    if (r.first == None) r.first = i;
+                    r.last = i;
+                };
+                for (const Use& use : m_passes[i].reads) touch(use);
+                for (const Use& use : m_passes[i].writes) touch(use);
+            }
+        }
+
+        // Greedy interval assignment in order of first use: a transient takes over the physical
+        // texture of any earlier transient with the same description whose last use has passed.
+        void assignPhysical() {
+            m_physical.clear();
+
+            std::vector<uint32_t> order;
+            for (uint32_t i = 0; i < m_resources.size(); i++)
+                if (m_resources[i].first != None) order.push_back(i);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return m_resources[a].first < m_resources[b].first; });
+
+            for (uint32_t id : order) {
+                Resource& r = m_resources[id];
+                if (r.imported) {
+                    r.physical = static_cast<uint32_t>(m_physical.size());
+                    m_physical.push_back({r.desc, r.imported, nullptr, r.last});
+                    continue;
+                }
+
+                m_stats.transientTextures++;
+                for (uint32_t p = 0; p < m_physical.size(); p++) {
+                    Physical& phys = m_physical[p];
+                    if (!phys.imported && phys.desc == r.desc && phys.lastUse < r.first) {
+                        r.physical = p;
+                        phys.lastUse = r.last;
+                        break;
+                    }
+                }
+
+                if (r.physical == None) {
+                    r.physical = static_cast<uint32_t>(m_physical.size());
+                    m_physical.push_back({r.desc, nullptr, nullptr, r.last});
+                    m_stats.physicalTextures++;
+                }
+            }
+        }
+
+        static GLbitfield barrierFor(Access access) {
+            switch (access) {
+                case Access::Sampled:         return GL_TEXTURE_FETCH_BARRIER_BIT;
+                case Access::ImageRead:
+                case Access::ImageWrite:      return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+                case Access::ColorAttachment:
+                case Access::DepthAttachment: return GL_FRAMEBUFFER_BARRIER_BIT;
+            }
+            return 0;
+        }
+
+        // Hazards are tracked per physical texture, since aliases share memory. After an image
+        // store, each later access needs the barrier bit for its own kind of access once; a
+        // glMemoryBarrier is global, so the bits issued before a pass cover every texture.
+        void planBarriers() {
+            std::vector<uint8_t> imageWritten(m_physical.size(), 0);
+            std::vector<GLbitfield> synced(m_physical.size(), 0);
+
+            for (uint32_t i = 0; i < m_passes.size(); i++) {
+                Pass& pass = m_passes[i];
+                pass.barriers = 0;
+                pass.invalidate.clear();
+                if (pass.culled) continue;
+
+                auto require = [&](const Use& use) {
+                    uint32_t p = m_resources[use.resource].physical;
+                    GLbitfield bit = barrierFor(use.access);
+                    if (imageWritten[p] && !(synced[p] & bit)) pass.barriers |= bit;
+                };
+                for (const Use& use : pass.reads) require(use);
+                for (const Use& use : pass.writes) require(use);
+
+                if (pass.barriers) {
+                    m_stats.barriers++;
+                    for (size_t p = 0; p < synced.size(); p++) synced[p] |= pass.barriers;
+                }
+
+                for (const Use& use : pass.writes) {
+                    const Resource& r = m_resources[use.resource];
+                    bool readsToo = std::any_of(pass.reads.begin(), pass.reads.end(), [&](const Use& read) { return read.resource == use.resource; });
+                    if (!r.imported && r.first == i && !readsToo) {
+                        pass.invalidate.push_back(use.resource);
+                        m_stats.invalidations++;
+                    }
+                    if (use.access == Access::ImageWrite) {
+                        imageWritten[r.physical] = 1;
+                        synced[r.physical] = 0;
+                    }
+                }
+            }
+        }
+
+        Texture2D& physicalTexture(uint32_t resource) {
+            Physical& p = m_physical[m_resources[resource].physical];
+            return p.imported ? *p.imported : *p.owned;
+        }
+
+        Framebuffer* bindTargets(uint32_t index) {
+            const Pass& pass = m_passes[index];
+            m_framebufferLayouts.resize(m_passes.size(), 0);
+
+            GLsizei colors = 0;
+            bool depth = false;
+            Texture2D* first = nullptr;
+            Framebuffer& fb = m_framebuffers[index];
+
+            for (const Use& use : pass.writes) {
+                if (use.access == Access::ColorAttachment) colors++;
+                if (use.access == Access::DepthAttachment) depth = true;
+            }
+
+            // Attachments left over from a differently shaped pass would still be written to.
+            GLuint layout = static_cast<GLuint>(colors) | (depth ? 0x10000u : 0u);
+            if (layout != m_framebufferLayouts[index]) fb.destroy();
+            m_framebufferLayouts[index] = layout;
+
+            GLuint slot = 0;
+            bool attached = false;
+            for (const Use& use : pass.writes) {
+                Texture2D& texture = physicalTexture(use.resource);
+                if (use.access == Access::ColorAttachment) {
+                    fb.attachColor(slot++, texture);
+                } else if (use.access == Access::DepthAttachment) {
+                    fb.create();
+                    fb.attachDepth(texture);
+                } else {
+                    continue;
+                }
+                if (!first) first = &texture;
+                attached = true;
+            }
+
+            if (!attached) return nullptr;
+
+            fb.drawBuffers(colors);
+            fb.bind();
+            State::viewport({0, 0, first->width(), first->height()});
+            return &fb;
+        }
+    };
+
+    inline Texture2D& PassContext::texture(FrameResource resource) const { return m_graph.physicalTexture(resource.id); }
+
+}
@@ -3,6 +3,8 @@
 #include <glballistic/State.h>
 #include "Renderbuffer.h"
 #include "Texture2D.h"
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace gl {
@@ -20,21 +22,24 @@ namespace gl {
             if (this != &other) {
                 destroy();
                 m_id = other.m_id;
+                m_colorAttachments = std::move(other.m_colorAttachments);
+                m_depthTexture = other.m_depthTexture;
+                m_depthRBO = other.m_depthRBO;
                 other.m_id = 0;
+                other.m_depthTexture = nullptr;
+                other.m_depthRBO = nullptr;
             }
             return *this;
         }
 
         void create() {
             if (m_id) return;
-            if (GLAD_GL_VERSION_4_5)
-                glCreateFramebuffers(1, &m_id);
-            else
-                glGenFramebuffers(1, &m_id);
+            m_id = State::names().framebuffers.acquire();
         }
 
         void destroy() {
             if (!m_id) return;
+            State::hazards().forgetFramebuffer(m_id);
             glDeleteFramebuffers(1, &m_id);
             m_id = 0;
             m_colorAttachments.clear();
@@ -53,6 +58,7 @@ namespace gl {
             create();
             m_colorAttachments.resize(std::max<size_t>(slot + 1, m_colorAttachments.size()));
             m_colorAttachments[slot] = &texture;
+            if (State::hazards().enabled()) State::hazards().framebufferTexture(m_id, slot + 1, texture.get());
             if (GLAD_GL_VERSION_4_5)
                 glNamedFramebufferTexture(m_id, GL_COLOR_ATTACHMENT0 + slot, texture.get(), 0);
             else {
@@ -64,12 +70,14 @@ namespace gl {
         void attachDepth(Renderbuffer& rbo) {
             m_depthRBO = &rbo;
             m_depthTexture = nullptr;
+            if (State::hazards().enabled()) State::hazards().framebufferTexture(m_id, 0, 0);
             rbo.attachToFramebuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT);
         }
 
         void attachDepth(Texture2D& texture) {
             m_depthTexture = &texture;
             m_depthRBO = nullptr;
+            if (State::hazards().enabled()) State::hazards().framebufferTexture(m_id, 0, texture.get());
             if (GLAD_GL_VERSION_4_5)
                 glNamedFramebufferTexture(m_id, GL_DEPTH_ATTACHMENT, texture.get(), 0);
             else {
@@ -78,17 +86,56 @@ namespace gl {
             }
         }
 
+        // Routes fragment outputs 0..count-1 to color attachments 0..count-1; 0 disables color writes.
+        void drawBuffers(GLsizei count) {
+            GLenum buffers[32];
+            count = std::min<GLsizei>(count, 32);
+            for (GLsizei i = 0; i < count; i++)
+                buffers[i] = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+            if (count == 0) buffers[0] = GL_NONE;
+
+            GLsizei n = std::max<GLsizei>(count, 1);
+            if (GLAD_GL_VERSION_4_5)
+                glNamedFramebufferDrawBuffers(m_id, n, buffers);
+            else {
+                bind();
+                glDrawBuffers(n, buffers);
+            }
+        }
+
+        // Resizes every attachment with its capacity policy and re-attaches the textures that
+        // moved to new storage. Attachments may end up larger than the requested size, so
+        // render through bindViewport() (or viewport()) rather than the attachment extents.
         void resize(GLsizei width, GLsizei height) {
             if (!m_id) return;
 
-            for (auto& tex : m_colorAttachments) {
-                if (tex) tex->resize(width, height);
+            for (GLuint slot = 0; slot < m_colorAttachments.size(); slot++) {
+                Texture2D* tex = m_colorAttachments[slot];
+                if (tex && tex->resize(width, height))
+                    attachColor(slot, *tex);
             }
 
-            if (m_depthTexture)
-                m_depthTexture->resize(width, height);
-            else if (m_depthRBO)
-                m_depthRBO->storage(m_depthRBO->internalFormat(), width, height);
+            if (m_depthTexture) {
+                if (m_depthTexture->resize(width, height))
+                    attachDepth(*m_depthTexture);
+            } else if (m_depthRBO) {
+                m_depthRBO->resize(width, height);
+            }
+        }
+
+        // The logical size of the first attachment, which is the area to render to.
+        Rect viewport() const {
+            for (const Texture2D* tex : m_colorAttachments) {
+                if (tex) return {0, 0, tex->width(), tex->height()};
+            }
+            if (m_depthTexture) return {0, 0, m_depthTexture->width(), m_depthTexture->height()};
+            if (m_depthRBO) return {0, 0, m_depthRBO->width(), m_depthRBO->height()};
+            return {};
+        }
+
+        void bindViewport() const {
+            bind();
+            State::viewport(viewport());
         }
 
         void label(const char* name) {
@@ -96,6 +143,15 @@ namespace gl {
                 glObjectLabel(GL_FRAMEBUFFER, m_id, -1, name);
         }
 
+        // Drops the pointers to the attached objects while leaving the GL attachments alone,
+        // for when the textures are about to be moved or deleted. resize() and viewport() then
+        // no longer see them; attach again before relying on either.
+        void forgetAttachments() {
+            m_colorAttachments.clear();
+            m_depthTexture = nullptr;
+            m_depthRBO = nullptr;
+        }
+
         Texture2D* getColorAttachment(GLuint slot) const {
             if (slot >= m_colorAttachments.size()) return nullptr;
             return m_colorAttachments[slot];
@@ -0,0 +1,223 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Allocator.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/IndirectCommandBuffer.h>
+#include <glballistic/VertexArray.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    struct MeshHandle {
+        GLuint id{~0u};
+
+        explicit operator bool() const { return id != ~0u; }
+        bool operator==(const MeshHandle&) const = default;
+    };
+
+    // Where a mesh currently lives inside the arena. Offsets change after compact(), so look
+    // them up through the handle rather than caching them across compactions.
+    struct GeometryMesh {
+        GLint baseVertex{0};
+        GLuint vertexCount{0};
+        GLuint firstIndex{0};
+        GLuint indexCount{0};
+    };
+
+    struct ArenaStats {
+        GLuint meshes{0};
+        GLuint vertexCapacity{0}, verticesUsed{0}, vertexFreeBlocks{0}, largestVertexBlock{0};
+        GLuint indexCapacity{0}, indicesUsed{0}, indexFreeBlocks{0}, largestIndexBlock{0};
+
+        float vertexOccupancy() const { return vertexCapacity ? static_cast<float>(verticesUsed) / static_cast<float>(vertexCapacity) : 0.0f; }
+        float indexOccupancy() const { return indexCapacity ? static_cast<float>(indicesUsed) / static_cast<float>(indexCapacity) : 0.0f; }
+    };
+
+    // Many meshes packed into one immutable vertex buffer and one index buffer, drawn through
+    // a single shared VertexArray. Vertex ranges are allocated in vertices and index ranges in
+    // indices by a TlsfAllocator, so a mesh's base vertex and first index fall straight out of
+    // its allocation and can be fed to glDrawElementsBaseVertex or an indirect command.
+    //
+    // All meshes share one vertex layout: describe it on vertexArray() with binding index 0.
+    // Indices are stored relative to the mesh's first vertex.
+    class GeometryArena {
+    public:
+        GeometryArena() = default;
+        ~GeometryArena() { destroy(); }
+
+        GeometryArena(const GeometryArena&) = delete;
+        GeometryArena& operator=(const GeometryArena&) = delete;
+
+        void create(GLsizei vertexStride, GLuint maxVertices, GLuint maxIndices, GLenum indexType = GL_UNSIGNED_INT) {
+            if (m_vertices.get()) return;
+
+            m_stride = vertexStride;
+            m_indexType = indexType;
+            m_vertexAllocator.init(maxVertices);
+            m_indexAllocator.init(maxIndices);
+
+            m_vertices = makeStorage(static_cast<GLsizeiptr>(maxVertices) * m_stride);
+            m_indices = makeStorage(static_cast<GLsizeiptr>(maxIndices) * IndexSize(m_indexType));
+
+            m_vertexArray.create();
+            attachBuffers();
+        }
+
+        void destroy() {
+            m_vertexArray.destroy();
+            m_vertices.destroy();
+            m_indices.destroy();
+            m_meshes.clear();
+            m_freeMeshes.clear();
+            m_vertexAllocator.init(0);
+            m_indexAllocator.init(0);
+        }
+
+        // Both counts must be non-zero. Returns an empty handle when either buffer has no free
+        // range large enough; compact() may make room if the arena is fragmented, not full.
+        MeshHandle add(const void* vertices, GLuint vertexCount, const void* indices, GLuint indexCount) {
+            uint32_t vertexBlock = m_vertexAllocator.allocate(vertexCount);
+            if (vertexBlock == TlsfAllocator::InvalidBlock) return {};
+
+            uint32_t indexBlock = m_indexAllocator.allocate(indexCount);
+            if (indexBlock == TlsfAllocator::InvalidBlock) {
+                m_vertexAllocator.free(vertexBlock);
+                return {};
+            }
+
+            GLuint id;
+            if (!m_freeMeshes.empty()) {
+                id = m_freeMeshes.back();
+                m_freeMeshes.pop_back();
+            } else {
+                id = static_cast<GLuint>(m_meshes.size());
+                m_meshes.emplace_back();
+            }
+            m_meshes[id] = {vertexBlock, indexBlock};
+
+            if (vertices)
+                m_vertices.update(vertexOffset(vertexBlock), static_cast<GLsizeiptr>(vertexCount) * m_stride, vertices);
+            if (indices)
+                m_indices.update(indexOffset(indexBlock), static_cast<GLsizeiptr>(indexCount) * IndexSize(m_indexType), indices);
+
+            return {id};
+        }
+
+        void remove(MeshHandle handle) {
+            if (!contains(handle)) return;
+            Slot& slot = m_meshes[handle.id];
+            m_vertexAllocator.free(slot.vertexBlock);
+            m_indexAllocator.free(slot.indexBlock);
+            slot = Slot{};
+            m_freeMeshes.push_back(handle.id);
+        }
+
+        bool contains(MeshHandle handle) const {
+            return handle.id < m_meshes.size() && m_meshes[handle.id].vertexBlock != TlsfAllocator::InvalidBlock;
+        }
+
+        GeometryMesh mesh(MeshHandle handle) const {
+            const Slot& slot = m_meshes[handle.id];
+            TlsfAllocator::Block v = m_vertexAllocator.block(slot.vertexBlock);
+            TlsfAllocator::Block i = m_indexAllocator.block(slot.indexBlock);
+            return {static_cast<GLint>(v.offset), v.size, i.offset, i.size};
+        }
+
+        DrawElementsIndirectCommand command(MeshHandle handle, GLuint instanceCount = 1, GLuint baseInstance = 0) const {
+            GeometryMesh m = mesh(handle);
+            return {m.indexCount, instanceCount, m.firstIndex, m.baseVertex, baseInstance};
+        }
+
+        void draw(MeshHandle handle, GLenum mode = GL_TRIANGLES, GLsizei instanceCount = 1, GLuint baseInstance = 0) const {
+            GeometryMesh m = mesh(handle);
+            const void* indices = reinterpret_cast<const void*>(static_cast<uintptr_t>(m.firstIndex) * IndexSize(m_indexType));
+            m_vertexArray.drawElementsBaseVertex(mode, static_cast<GLsizei>(m.indexCount), indices, m.baseVertex, instanceCount, baseInstance);
+        }
+
+        void draw(const DrawElementsCommandBuffer& commands, GLenum mode = GL_TRIANGLES) const {
+            m_vertexArray.multiDrawElementsIndirect(mode, commands);
+        }
+
+        // Packs every mesh to the front of both buffers so the free space becomes one block.
+        // The data is copied on the GPU into freshly allocated buffers, which replace the old
+        // ones in the shared VertexArray; handles stay valid but their offsets change.
+        void compact() {
+            if (!m_vertices.get()) return;
+            GLBALLISTIC_PROFILE_ZONE("GeometryArena::compact");
+
+            Buffer vertices = makeStorage(m_vertices.size());
+            m_vertexAllocator.compact([&](uint32_t, uint32_t from, uint32_t to, uint32_t count) {
+                vertices.copy(m_vertices, static_cast<GLintptr>(from) * m_stride, static_cast<GLintptr>(to) * m_stride, static_cast<GLsizeiptr>(count) * m_stride);
+            });
+
+            GLsizeiptr indexSize = IndexSize(m_indexType);
+            Buffer indices = makeStorage(m_indices.size());
+            m_indexAllocator.compact([&](uint32_t, uint32_t from, uint32_t to, uint32_t count) {
+                indices.copy(m_indices, static_cast<GLintptr>(from) * indexSize, static_cast<GLintptr>(to) * indexSize, static_cast<GLsizeiptr>(count) * indexSize);
+            });
+
+            m_vertices = std::move(vertices);
+            m_indices = std::move(indices);
+            attachBuffers();
+        }
+
+        ArenaStats stats() const {
+            ArenaStats s;
+            s.meshes = static_cast<GLuint>(m_meshes.size() - m_freeMeshes.size());
+            s.vertexCapacity = m_vertexAllocator.capacity();
+            s.verticesUsed = m_vertexAllocator.used();
+            s.vertexFreeBlocks = m_vertexAllocator.freeBlocks();
+            s.largestVertexBlock = m_vertexAllocator.largestFree();
+            s.indexCapacity = m_indexAllocator.capacity();
+            s.indicesUsed = m_indexAllocator.used();
+            s.indexFreeBlocks = m_indexAllocator.freeBlocks();
+            s.largestIndexBlock = m_indexAllocator.largestFree();
+            return s;
+        }
+
+        VertexArray& vertexArray() { return m_vertexArray; }
+        const VertexArray& vertexArray() const { return m_vertexArray; }
+        const Buffer& vertexBuffer() const { return m_vertices; }
+        const Buffer& indexBuffer() const { return m_indices; }
+        GLsizei vertexStride() const { return m_stride; }
+        GLenum indexType() const { return m_indexType; }
+
+    private:
+        struct Slot {
+            uint32_t vertexBlock{TlsfAllocator::InvalidBlock};
+            uint32_t indexBlock{TlsfAllocator::InvalidBlock};
+        };
+
+        Buffer m_vertices;
+        Buffer m_indices;
+        VertexArray m_vertexArray;
+        TlsfAllocator m_vertexAllocator;
+        TlsfAllocator m_indexAllocator;
+        std::vector<Slot> m_meshes;
+        std::vector<GLuint> m_freeMeshes;
+        GLsizei m_stride{0};
+        GLenum m_indexType{GL_UNSIGNED_INT};
+
+        // Created on GL_COPY_WRITE_BUFFER: the non-DSA storage call binds the buffer, and on
+        // GL_ELEMENT_ARRAY_BUFFER that would replace the index buffer of whatever VAO is bound.
+        static Buffer makeStorage(GLsizeiptr size) {
+            Buffer buffer;
+            buffer.create(GL_COPY_WRITE_BUFFER);
+            buffer.storage(size, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            return buffer;
+        }
+
+        void attachBuffers() {
+            m_vertexArray.vertexBuffer(0, m_vertices.get(), 0, m_stride);
+            m_vertexArray.indexBuffer(m_indices.get(), m_indexType);
+        }
+
+        GLintptr vertexOffset(uint32_t block) const { return static_cast<GLintptr>(m_vertexAllocator.block(block).offset) * m_stride; }
+        GLintptr indexOffset(uint32_t block) const { return static_cast<GLintptr>(m_indexAllocator.block(block).offset) * IndexSize(m_indexType); }
+    };
+
+}
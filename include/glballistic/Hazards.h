@@ -0,0 +1,295 @@
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    // Off:      nothing is tracked; barriers are entirely the caller's job.
+    // Auto:     the library issues the barrier bits a command needs right before it runs.
+    // Validate: nothing is issued automatically. Commands that consume an unordered shader
+    //           write, and explicit barriers that order no pending write, are reported.
+    enum class HazardMode {
+        Off,
+        Auto,
+        Validate
+    };
+
+    enum class HazardResource : uint8_t {
+        Buffer,
+        Texture
+    };
+
+    struct HazardReport {
+        enum Kind { Missing, Redundant };
+
+        Kind kind;
+        HazardResource resource;
+        GLuint id;          // 0 for redundant barriers
+        GLbitfield bits;
+        const char* consumer;
+    };
+
+    struct HazardStats {
+        uint64_t writes{0};
+        uint64_t barriers{0};           // glMemoryBarrier calls made by the tracker
+        uint64_t explicitBarriers{0};   // State::memoryBarrier calls
+        uint64_t missing{0};
+        uint64_t redundant{0};
+    };
+
+    // Pending incoherent writes, i.e. image stores, storage buffer writes and atomic counter
+    // operations, keyed by the object they went to. A write leaves every barrier bit pending
+    // on its object; glMemoryBarrier is global, so issuing bits clears them from every object.
+    // A consumer asks for the one bit that orders its kind of access (TEXTURE_FETCH for
+    // sampling, COMMAND for indirect arguments, ...) on each object it touches, and only the
+    // bits still pending on those objects are issued, coalesced into one call per command.
+    //
+    // The writers of the next draw or dispatch are the image units bound with write access,
+    // the storage buffers not bound GL_READ_ONLY and all atomic counter buffers. Shaders that
+    // only read a storage buffer should bind it GL_READ_ONLY, or it counts as written.
+    // Likewise every bound texture, image and buffer counts as read: bindings are not matched
+    // against the program's interface, so stale bindings can cost extra barrier bits.
+    class HazardTracker {
+    public:
+        using ReportHandler = std::function<void(const HazardReport&)>;
+
+        static constexpr GLbitfield TrackedBits =
+            GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT |
+            GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_COMMAND_BARRIER_BIT |
+            GL_PIXEL_BUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT |
+            GL_FRAMEBUFFER_BARRIER_BIT | GL_TRANSFORM_FEEDBACK_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT |
+            GL_SHADER_STORAGE_BARRIER_BIT | GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT | GL_QUERY_BUFFER_BARRIER_BIT;
+
+        void setMode(HazardMode mode) {
+            m_mode = mode;
+            if (mode == HazardMode::Off) {
+                m_pending.clear();
+                m_missing.clear();
+                m_needed = 0;
+                clearBindings();
+                m_vertexArrays.clear();
+                m_framebuffers.clear();
+            }
+        }
+
+        HazardMode mode() const { return m_mode; }
+        bool enabled() const { return m_mode != HazardMode::Off; }
+        bool hasPending() const { return !m_pending.empty(); }
+
+        // Replaces the default, which prints to std::cerr.
+        void setReportHandler(ReportHandler handler) { m_handler = std::move(handler); }
+
+        void bindImage(GLuint unit, GLuint texture, GLenum access) {
+            setWriter(m_imageWriters, unit, access == GL_READ_ONLY ? 0 : texture);
+        }
+
+        void bindStorage(GLenum target, GLuint index, GLuint buffer, GLenum access) {
+            if (target == GL_SHADER_STORAGE_BUFFER)
+                setWriter(m_storageWriters, index, access == GL_READ_ONLY ? 0 : buffer);
+            else if (target == GL_ATOMIC_COUNTER_BUFFER)
+                setWriter(m_atomicWriters, index, buffer);
+        }
+
+        void clearBindings() {
+            m_imageWriters.clear();
+            m_storageWriters.clear();
+            m_atomicWriters.clear();
+        }
+
+        // Records the writes the command about to run can make through the current bindings.
+        void recordWrites() {
+            for (GLuint id : m_imageWriters)
+                if (id) write(HazardResource::Texture, id);
+            for (GLuint id : m_storageWriters)
+                if (id) write(HazardResource::Buffer, id);
+            for (GLuint id : m_atomicWriters)
+                if (id) write(HazardResource::Buffer, id);
+        }
+
+        void write(HazardResource resource, GLuint id) {
+            m_stats.writes++;
+            uint64_t k = key(resource, id);
+            for (Pending& p : m_pending) {
+                if (p.key == k) {
+                    p.bits = TrackedBits;
+                    return;
+                }
+            }
+            m_pending.push_back({k, TrackedBits});
+        }
+
+        // For objects whose storage is deleted or respecified; earlier writes no longer matter.
+        void forget(HazardResource resource, GLuint id) {
+            uint64_t k = key(resource, id);
+            std::erase_if(m_pending, [k](const Pending& p) { return p.key == k; });
+        }
+
+        // The command about to run accesses id in the way bit orders.
+        void require(HazardResource resource, GLuint id, GLbitfield bit) {
+            if (!id || m_pending.empty()) return;
+            uint64_t k = key(resource, id);
+            for (const Pending& p : m_pending) {
+                if (p.key != k) continue;
+                GLbitfield missing = p.bits & bit;
+                if (!missing) return;
+                m_needed |= missing;
+                if (m_mode == HazardMode::Validate) m_missing.push_back({resource, id, missing});
+                return;
+            }
+        }
+
+        // Issues (Auto) or reports (Validate) what require() collected for the command.
+        // Reported hazards are then treated as ordered, so each one is reported once.
+        void resolve(const char* consumer) {
+            if (!m_needed) return;
+
+            if (m_mode == HazardMode::Auto) {
+                glMemoryBarrier(m_needed);
+                m_stats.barriers++;
+            } else {
+                for (const Missing& m : m_missing) {
+                    m_stats.missing++;
+                    report({HazardReport::Missing, m.resource, m.id, m.bits, consumer});
+                }
+                m_missing.clear();
+            }
+
+            clearBits(m_needed);
+            m_needed = 0;
+        }
+
+        // Bookkeeping for a barrier issued outside the tracker.
+        void barrier(GLbitfield bits) {
+            m_stats.explicitBarriers++;
+            if (m_mode == HazardMode::Validate) {
+                GLbitfield outstanding = 0;
+                for (const Pending& p : m_pending)
+                    outstanding |= p.bits;
+                if (!(bits & outstanding)) {
+                    m_stats.redundant++;
+                    report({HazardReport::Redundant, HazardResource::Buffer, 0, bits, "glMemoryBarrier"});
+                }
+            }
+            clearBits(bits);
+        }
+
+        // Containers whose contents commands consume implicitly: vertex and element buffers of
+        // a vertex array, texture attachments of a framebuffer. A container is learned whole
+        // through setVertexArray()/setFramebuffer() the first time a command uses it, since it
+        // may have been edited while tracking was off; the edit hooks only update known ones.
+        bool knowsVertexArray(GLuint vao) const { return !vao || m_vertexArrays.contains(vao); }
+        bool knowsFramebuffer(GLuint fbo) const { return !fbo || m_framebuffers.contains(fbo); }
+
+        void setVertexArray(GLuint vao, std::vector<GLuint> vertex, GLuint elements) {
+            m_vertexArrays[vao] = {std::move(vertex), elements};
+        }
+
+        void setFramebuffer(GLuint fbo, std::vector<GLuint> textures) { m_framebuffers[fbo] = std::move(textures); }
+
+        void vertexArrayBuffer(GLuint vao, GLuint bindingIndex, GLuint buffer) {
+            auto it = m_vertexArrays.find(vao);
+            if (it != m_vertexArrays.end()) setWriter(it->second.vertex, bindingIndex, buffer);
+        }
+
+        void vertexArrayElements(GLuint vao, GLuint buffer) {
+            auto it = m_vertexArrays.find(vao);
+            if (it != m_vertexArrays.end()) it->second.elements = buffer;
+        }
+
+        void framebufferTexture(GLuint fbo, GLuint slot, GLuint texture) {
+            auto it = m_framebuffers.find(fbo);
+            if (it != m_framebuffers.end()) setWriter(it->second, slot, texture);
+        }
+
+        void forgetVertexArray(GLuint vao) { m_vertexArrays.erase(vao); }
+        void forgetFramebuffer(GLuint fbo) { m_framebuffers.erase(fbo); }
+
+        void requireVertexArray(GLuint vao, bool indexed) {
+            auto it = m_vertexArrays.find(vao);
+            if (it == m_vertexArrays.end()) return;
+            for (GLuint id : it->second.vertex)
+                require(HazardResource::Buffer, id, GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+            if (indexed)
+                require(HazardResource::Buffer, it->second.elements, GL_ELEMENT_ARRAY_BARRIER_BIT);
+        }
+
+        void requireFramebuffer(GLuint fbo) {
+            auto it = m_framebuffers.find(fbo);
+            if (it == m_framebuffers.end()) return;
+            for (GLuint id : it->second)
+                require(HazardResource::Texture, id, GL_FRAMEBUFFER_BARRIER_BIT);
+        }
+
+        const HazardStats& stats() const { return m_stats; }
+        void resetStats() { m_stats = HazardStats{}; }
+
+    private:
+        struct Pending {
+            uint64_t key;
+            GLbitfield bits;
+        };
+
+        struct Missing {
+            HazardResource resource;
+            GLuint id;
+            GLbitfield bits;
+        };
+
+        struct VertexArrayBuffers {
+            std::vector<GLuint> vertex;
+            GLuint elements{0};
+        };
+
+        HazardMode m_mode{HazardMode::Off};
+        std::vector<Pending> m_pending;
+        std::vector<Missing> m_missing;
+        GLbitfield m_needed{0};
+
+        std::vector<GLuint> m_imageWriters;
+        std::vector<GLuint> m_storageWriters;
+        std::vector<GLuint> m_atomicWriters;
+        std::unordered_map<GLuint, VertexArrayBuffers> m_vertexArrays;
+        std::unordered_map<GLuint, std::vector<GLuint>> m_framebuffers;
+
+        HazardStats m_stats;
+        ReportHandler m_handler;
+
+        static uint64_t key(HazardResource resource, GLuint id) { return (static_cast<uint64_t>(resource) << 32) | id; }
+
+        static void setWriter(std::vector<GLuint>& slots, GLuint index, GLuint id) {
+            if (index >= slots.size()) {
+                if (!id) return;
+                slots.resize(index + 1, 0);
+            }
+            slots[index] = id;
+        }
+
+        void clearBits(GLbitfield bits) {
+            for (Pending& p : m_pending)
+                p.bits &= ~bits;
+            std::erase_if(m_pending, [](const Pending& p) { return p.bits == 0; });
+        }
+
+        void report(const HazardReport& r) {
+            if (m_handler) {
+                m_handler(r);
+                return;
+            }
+            if (r.kind == HazardReport::Missing) {
+                std::cerr << "Barrier validation: " << r.consumer << " reads "
+                          << (r.resource == HazardResource::Texture ? "texture " : "buffer ") << r.id
+                          << " after a shader write without barrier bits 0x" << std::hex << r.bits << std::dec << std::endl;
+            } else {
+                std::cerr << "Barrier validation: glMemoryBarrier(0x" << std::hex << r.bits << std::dec
+                          << ") orders no pending shader write" << std::endl;
+            }
+        }
+    };
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Buffer.h>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    // Layouts consumed by glDrawArraysIndirect / glMultiDrawArraysIndirect(Count).
+    struct DrawArraysIndirectCommand {
+        GLuint count{0};
+        GLuint instanceCount{1};
+        GLuint first{0};
+        GLuint baseInstance{0};
+    };
+
+    // Layouts consumed by glDrawElementsIndirect / glMultiDrawElementsIndirect(Count).
+    // firstIndex counts indices, not bytes.
+    struct DrawElementsIndirectCommand {
+        GLuint count{0};
+        GLuint instanceCount{1};
+        GLuint firstIndex{0};
+        GLint baseVertex{0};
+        GLuint baseInstance{0};
+    };
+
+    static_assert(sizeof(DrawArraysIndirectCommand) == 16);
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+    // Commands are collected in client memory and uploaded to a GL_DRAW_INDIRECT_BUFFER in one
+    // call, so a whole pass can be submitted with a single multi-draw. The buffer grows
+    // geometrically when more commands are pushed than it can hold and never shrinks.
+    // Every upload after the first orphans the storage, so rewriting the commands each frame
+    // never waits for draws still reading the previous ones.
+    template<typename Command>
+    class IndirectCommandBuffer {
+    public:
+        IndirectCommandBuffer() = default;
+
+        IndirectCommandBuffer(const IndirectCommandBuffer&) = delete;
+        IndirectCommandBuffer& operator=(const IndirectCommandBuffer&) = delete;
+
+        IndirectCommandBuffer(IndirectCommandBuffer&& other) noexcept { *this = std::move(other); }
+        IndirectCommandBuffer& operator=(IndirectCommandBuffer&& other) noexcept {
+            if (this != &other) {
+                m_buffer = std::move(other.m_buffer);
+                m_commands = std::move(other.m_commands);
+                m_capacity = other.m_capacity;
+                m_uploaded = other.m_uploaded;
+                other.m_capacity = 0;
+                other.m_uploaded = 0;
+            }
+            return *this;
+        }
+
+        void create(GLsizei capacity = 256) {
+            if (m_buffer.get()) return;
+            m_buffer.create(GL_DRAW_INDIRECT_BUFFER);
+            reserve(capacity);
+        }
+
+        void destroy() {
+            m_buffer.destroy();
+            m_commands.clear();
+            m_capacity = 0;
+            m_uploaded = 0;
+        }
+
+        // Returns the index of the command, which is also its draw ID (gl_DrawID).
+        GLsizei push(const Command& command) {
+            m_commands.push_back(command);
+            return static_cast<GLsizei>(m_commands.size() - 1);
+        }
+
+        Command& operator[](GLsizei index) { return m_commands[static_cast<size_t>(index)]; }
+        const Command& operator[](GLsizei index) const { return m_commands[static_cast<size_t>(index)]; }
+
+        void clear() { m_commands.clear(); }
+
+        // Copies the recorded commands into the GPU buffer, reallocating it if they no
+        // longer fit. Must run before the draw that reads them.
+        void upload() {
+            GLsizei count = size();
+            if (count > m_capacity)
+                reserve(std::max(count, m_capacity * 2));
+            else if (m_uploaded > 0 && count > 0)
+                allocate();
+            if (count > 0)
+                m_buffer.update(0, static_cast<GLsizeiptr>(count) * Stride, m_commands.data());
+            m_uploaded = count;
+        }
+
+        void reserve(GLsizei capacity) {
+            if (capacity <= m_capacity && m_capacity > 0) return;
+            m_capacity = std::max<GLsizei>(capacity, 1);
+            allocate();
+        }
+
+        void bind() const { State::bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_buffer.get()); }
+
+        Buffer& buffer() { return m_buffer; }
+        const Buffer& buffer() const { return m_buffer; }
+        GLuint get() const { return m_buffer.get(); }
+
+        const std::vector<Command>& commands() const { return m_commands; }
+        GLsizei size() const { return static_cast<GLsizei>(m_commands.size()); }
+        GLsizei capacity() const { return m_capacity; }
+        GLsizei uploaded() const { return m_uploaded; }
+        bool empty() const { return m_commands.empty(); }
+
+        static constexpr GLsizei Stride = static_cast<GLsizei>(sizeof(Command));
+
+    private:
+        Buffer m_buffer;
+        std::vector<Command> m_commands;
+        GLsizei m_capacity{0};
+        GLsizei m_uploaded{0};
+
+        // Respecifies the storage; the driver hands out a fresh block and frees the old one
+        // once pending draws are done with it.
+        void allocate() {
+            m_buffer.data(static_cast<GLsizeiptr>(m_capacity) * Stride, nullptr, GL_STREAM_DRAW);
+            m_uploaded = 0;
+        }
+    };
+
+    using DrawArraysCommandBuffer = IndirectCommandBuffer<DrawArraysIndirectCommand>;
+    using DrawElementsCommandBuffer = IndirectCommandBuffer<DrawElementsIndirectCommand>;
+
+}
@@ -1,49 +1,150 @@
 #pragma once
 #include <glad/glad.h>
+#include <glballistic/State.h>
+#include <algorithm>
 
 namespace gl {
     
     inline void ClearColor(float r, float g, float b, float a = 1.0f) {
-        glClearColor(r, g, b, a);
+        State::clearColor(r, g, b, a);
     }
 
     inline void Clear(GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT) {
         glClear(mask);
     }
 
+    inline void Enable(GLenum cap) {
+        State::enable(cap, true);
+    }
+
+    inline void Disable(GLenum cap) {
+        State::enable(cap, false);
+    }
+
     inline void Viewport(int x, int y, int width, int height) {
-        glViewport(x, y, width, height);
+        State::viewport({x, y, width, height});
     }
 
     inline void Scissor(int x, int y, int w, int h) {
-        glScissor(x, y, w, h);
+        State::scissor({x, y, w, h});
     }
 
     inline void DepthFunc(GLenum func) {
-        glDepthFunc(func);
+        State::depthFunc(func);
     }
 
     inline void DepthMask(bool write) {
-        glDepthMask(write ? GL_TRUE : GL_FALSE);
+        State::depthMask(write);
     }
 
     inline void BlendFunc(GLenum src, GLenum dst) {
-        glBlendFunc(src, dst);
+        State::blendFunc(src, dst, src, dst);
+    }
+
+    inline void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+        State::blendFunc(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    }
+
+    inline void BlendEquation(GLenum op) {
+        State::blendEquation(op, op);
+    }
+
+    inline void StencilFunc(GLenum func, GLint ref, GLuint mask = ~0u) {
+        State::stencilFunc(func, ref, mask);
+    }
+
+    inline void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+        State::stencilOp(sfail, dpfail, dppass);
+    }
+
+    inline void StencilMask(GLuint mask) {
+        State::stencilMask(mask);
     }
 
     inline void CullFace(GLenum face) {
-        glCullFace(face);
+        State::cullFace(face);
     }
 
     inline void FrontFace(GLenum winding) {
-        glFrontFace(winding);
+        State::frontFace(winding);
     }
 
     inline void PolygonMode(GLenum mode) {
-        glPolygonMode(GL_FRONT_AND_BACK, mode);
+        State::polygonMode(mode);
+    }
+
+    inline void PolygonOffset(float factor, float units) {
+        State::polygonOffset(factor, units);
     }
 
     inline void ColorMask(bool r, bool g, bool b, bool a = 1.0f) {
-        glColorMask(r, g, b, a);
+        State::colorMask((r ? 1u : 0u) | (g ? 2u : 0u) | (b ? 4u : 0u) | (a ? 8u : 0u));
+    }
+
+    inline GLsizei ComponentCount(GLenum format) {
+        switch (format) {
+            case GL_RED: case GL_GREEN: case GL_BLUE: case GL_ALPHA:
+            case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: case GL_STENCIL_INDEX:
+                return 1;
+            case GL_RG: case GL_RG_INTEGER: case GL_DEPTH_STENCIL:
+                return 2;
+            case GL_RGB: case GL_BGR: case GL_RGB_INTEGER: case GL_BGR_INTEGER:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+    inline GLsizei PixelSize(GLenum format, GLenum type) {
+        switch (type) {
+            case GL_UNSIGNED_BYTE: case GL_BYTE:
+                return ComponentCount(format);
+            case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+                return 2 * ComponentCount(format);
+            case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT:
+                return 4 * ComponentCount(format);
+            case GL_UNSIGNED_BYTE_3_3_2: case GL_UNSIGNED_BYTE_2_3_3_REV:
+                return 1;
+            case GL_UNSIGNED_SHORT_5_6_5: case GL_UNSIGNED_SHORT_4_4_4_4: case GL_UNSIGNED_SHORT_5_5_5_1:
+                return 2;
+            case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+                return 8;
+            default:
+                return 4;
+        }
+    }
+
+    inline GLsizei IndexSize(GLenum type) {
+        switch (type) {
+            case GL_UNSIGNED_BYTE:  return 1;
+            case GL_UNSIGNED_SHORT: return 2;
+            default:                return 4;
+        }
+    }
+
+    // Allocated extent along one axis for a render target resized to `requested`. Grows by
+    // half again so a window drag reallocates a handful of times, and only shrinks once less
+    // than half of the allocation is in use.
+    inline GLsizei TargetCapacity(GLsizei capacity, GLsizei requested) {
+        if (requested > capacity) return std::max(requested, capacity + capacity / 2);
+        if (requested <= capacity / 2) return requested;
+        return capacity;
+    }
+
+    inline GLsizeiptr BufferOffsetAlignment(GLenum target) {
+        GLint alignment = 0;
+        if (target == GL_UNIFORM_BUFFER)
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        else if (target == GL_SHADER_STORAGE_BUFFER)
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return alignment > 0 ? alignment : 16;
+    }
+
+    inline void ApplyRenderState(const RenderState& rs) {
+        State::apply(rs);
+    }
+
+    inline void ApplyPipeline(const PipelineState& pipeline) {
+        State::apply(pipeline);
     }
 }
\ No newline at end of file
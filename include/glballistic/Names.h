@@ -0,0 +1,156 @@
+#pragma once
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gl {
+
+    enum class ObjectKind {
+        Buffer,
+        Texture2D,
+        Texture2DArray,
+        Texture3D,
+        TextureCube,
+        VertexArray,
+        Framebuffer,
+        Renderbuffer
+    };
+
+    struct NamePoolStats {
+        uint64_t batches{0};
+        uint64_t created{0};
+        uint64_t acquired{0};
+    };
+
+    // Hands out object names that were created ahead of time, batchSize per driver call. With
+    // DSA the names come from glCreate*, so they are already initialized objects; otherwise
+    // they come from glGen* and become objects on first bind, exactly as a single glGen* name
+    // would. A batch size of 1 (the default) makes acquire() a plain one-name create.
+    //
+    // Names are not recycled: destroyed objects are deleted as usual. Reusing live objects is
+    // what TexturePool, BufferPool and RenderbufferPool are for.
+    class NamePool {
+    public:
+        explicit NamePool(ObjectKind kind) : m_kind(kind) {}
+
+        NamePool(const NamePool&) = delete;
+        NamePool& operator=(const NamePool&) = delete;
+
+        void setBatchSize(GLsizei size) { m_batchSize = std::max<GLsizei>(size, 1); }
+        GLsizei batchSize() const { return m_batchSize; }
+
+        GLuint acquire() {
+            if (m_names.empty()) refill(m_batchSize);
+            GLuint id = m_names.back();
+            m_names.pop_back();
+            m_stats.acquired++;
+            return id;
+        }
+
+        // Creates names up front, e.g. during loading, so acquire() never calls the driver.
+        void reserve(GLsizei count) {
+            if (static_cast<size_t>(count) > m_names.size())
+                refill(count - static_cast<GLsizei>(m_names.size()));
+        }
+
+        // Deletes the names that were created but never handed out. Needs the owning context
+        // to be current, so call it before tearing the context down.
+        void clear() {
+            if (m_names.empty()) return;
+            GLsizei n = static_cast<GLsizei>(m_names.size());
+            switch (m_kind) {
+                case ObjectKind::Buffer:       glDeleteBuffers(n, m_names.data()); break;
+                case ObjectKind::Texture2D:
+                case ObjectKind::Texture2DArray:
+                case ObjectKind::Texture3D:
+                case ObjectKind::TextureCube:  glDeleteTextures(n, m_names.data()); break;
+                case ObjectKind::VertexArray:  glDeleteVertexArrays(n, m_names.data()); break;
+                case ObjectKind::Framebuffer:  glDeleteFramebuffers(n, m_names.data()); break;
+                case ObjectKind::Renderbuffer: glDeleteRenderbuffers(n, m_names.data()); break;
+            }
+            m_names.clear();
+        }
+
+        size_t available() const { return m_names.size(); }
+        const NamePoolStats& stats() const { return m_stats; }
+        ObjectKind kind() const { return m_kind; }
+
+    private:
+        ObjectKind m_kind;
+        GLsizei m_batchSize{1};
+        std::vector<GLuint> m_names;
+        NamePoolStats m_stats;
+
+        void refill(GLsizei count) {
+            size_t start = m_names.size();
+            m_names.resize(start + static_cast<size_t>(count));
+            GLuint* ids = m_names.data() + start;
+
+            bool dsa = GLAD_GL_VERSION_4_5;
+            switch (m_kind) {
+                case ObjectKind::Buffer:
+                    dsa ? glCreateBuffers(count, ids) : glGenBuffers(count, ids);
+                    break;
+                case ObjectKind::Texture2D:
+                    dsa ? glCreateTextures(GL_TEXTURE_2D, count, ids) : glGenTextures(count, ids);
+                    break;
+                case ObjectKind::Texture2DArray:
+                    dsa ? glCreateTextures(GL_TEXTURE_2D_ARRAY, count, ids) : glGenTextures(count, ids);
+                    break;
+                case ObjectKind::Texture3D:
+                    dsa ? glCreateTextures(GL_TEXTURE_3D, count, ids) : glGenTextures(count, ids);
+                    break;
+                case ObjectKind::TextureCube:
+                    dsa ? glCreateTextures(GL_TEXTURE_CUBE_MAP, count, ids) : glGenTextures(count, ids);
+                    break;
+                case ObjectKind::VertexArray:
+                    dsa ? glCreateVertexArrays(count, ids) : glGenVertexArrays(count, ids);
+                    break;
+                case ObjectKind::Framebuffer:
+                    dsa ? glCreateFramebuffers(count, ids) : glGenFramebuffers(count, ids);
+                    break;
+                case ObjectKind::Renderbuffer:
+                    dsa ? glCreateRenderbuffers(count, ids) : glGenRenderbuffers(count, ids);
+                    break;
+            }
+
+            // Hand names out in the order the driver returned them.
+            std::reverse(m_names.begin() + static_cast<std::ptrdiff_t>(start), m_names.end());
+            m_stats.batches++;
+            m_stats.created += static_cast<uint64_t>(count);
+        }
+    };
+
+    // One NamePool per wrapper type. Framebuffer and vertex array names are not shared between
+    // contexts, which is why these live in the per-context Context. Textures get a pool per
+    // target because glCreateTextures fixes the target at creation.
+    struct ObjectNames {
+        NamePool buffers{ObjectKind::Buffer};
+        NamePool textures2D{ObjectKind::Texture2D};
+        NamePool textures2DArray{ObjectKind::Texture2DArray};
+        NamePool textures3D{ObjectKind::Texture3D};
+        NamePool texturesCube{ObjectKind::TextureCube};
+        NamePool vertexArrays{ObjectKind::VertexArray};
+        NamePool framebuffers{ObjectKind::Framebuffer};
+        NamePool renderbuffers{ObjectKind::Renderbuffer};
+
+        void setBatchSize(GLsizei size) {
+            for (NamePool* pool : all())
+                pool->setBatchSize(size);
+        }
+
+        void clear() {
+            for (NamePool* pool : all())
+                pool->clear();
+        }
+
+    private:
+        std::array<NamePool*, 8> all() {
+            return {&buffers, &textures2D, &textures2DArray, &textures3D, &texturesCube, &vertexArrays, &framebuffers, &renderbuffers};
+        }
+    };
+
+}
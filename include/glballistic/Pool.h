@@ -0,0 +1,213 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/Renderbuffer.h>
+#include <glballistic/Texture2D.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    struct PoolStats {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t released{0};
+        uint64_t evicted{0};
+        size_t idle{0};
+
+        double hitRate() const { return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0; }
+    };
+
+    // Bytewise FNV-1a for padding-free key structs.
+    template<typename Key>
+    struct PodHash {
+        size_t operator()(const Key& key) const noexcept {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(&key);
+            uint64_t h = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(Key); i++) {
+                h ^= bytes[i];
+                h *= 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    // Idle objects bucketed by a description key. acquire() hands back an idle object with
+    // the same key when there is one and calls make() otherwise; release() parks an object
+    // for reuse instead of deleting it. nextFrame() deletes whatever has sat idle too long.
+    template<typename T, typename Key>
+    class ObjectPool {
+    public:
+        template<typename Make>
+        T acquire(const Key& key, Make&& make) {
+            auto it = m_idle.find(key);
+            if (it != m_idle.end() && !it->second.empty()) {
+                T object = std::move(it->second.back().object);
+                it->second.pop_back();
+                m_stats.hits++;
+                m_stats.idle--;
+                return object;
+            }
+            m_stats.misses++;
+            return make();
+        }
+
+        void release(const Key& key, T&& object) {
+            if (!object.get()) return;
+            m_idle[key].push_back({std::move(object), m_frame});
+            m_stats.released++;
+            m_stats.idle++;
+        }
+
+        void nextFrame(uint64_t maxIdleFrames) {
+            m_frame++;
+            for (auto& [key, entries] : m_idle) {
+                size_t kept = 0;
+                for (auto& entry : entries) {
+                    if (m_frame - entry.frame <= maxIdleFrames)
+                        entries[kept++] = std::move(entry);
+                    else
+                        m_stats.evicted++;
+                }
+                m_stats.idle -= entries.size() - kept;
+                entries.resize(kept);
+            }
+        }
+
+        void clear() {
+            m_stats.evicted += m_stats.idle;
+            m_stats.idle = 0;
+            m_idle.clear();
+        }
+
+        const PoolStats& stats() const { return m_stats; }
+        void resetStats() { m_stats = PoolStats{0, 0, 0, 0, m_stats.idle}; }
+
+    private:
+        struct Entry {
+            T object;
+            uint64_t frame;
+        };
+
+        std::unordered_map<Key, std::vector<Entry>, PodHash<Key>> m_idle;
+        PoolStats m_stats;
+        uint64_t m_frame{0};
+    };
+
+    struct TextureKey {
+        GLsizei width{0}, height{0}, levels{1};
+        GLenum internalFormat{0}, format{0}, type{0};
+
+        bool operator==(const TextureKey&) const = default;
+    };
+
+    struct RenderbufferKey {
+        GLenum internalFormat{0};
+        GLsizei width{0}, height{0}, samples{0};
+
+        bool operator==(const RenderbufferKey&) const = default;
+    };
+
+    struct BufferKey {
+        GLsizeiptr size{0};
+        GLbitfield flags{0};
+        GLenum target{0};
+
+        bool operator==(const BufferKey&) const = default;
+    };
+
+    static_assert(sizeof(TextureKey) == 6 * sizeof(GLuint), "pool keys must stay padding-free for hashing");
+    static_assert(sizeof(RenderbufferKey) == 4 * sizeof(GLuint), "pool keys must stay padding-free for hashing");
+    static_assert(sizeof(BufferKey) == sizeof(GLsizeiptr) + 2 * sizeof(GLuint), "pool keys must stay padding-free for hashing");
+
+    // Recycles immutable 2D textures, typically per-pass render targets, by size and format.
+    // Sampler parameters and contents are whatever the previous user left behind.
+    // Pooled objects are keyed by their storage, not their logical size, since a resized
+    // texture or renderbuffer may be larger than it reports. acquire() resets the logical size.
+    class TexturePool {
+    public:
+        Texture2D acquire(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1) {
+            Texture2D texture = m_pool.acquire({width, height, levels, internalFormat, format, type}, [&] {
+                Texture2D created;
+                created.create(width, height, internalFormat, format, type, levels);
+                return created;
+            });
+            texture.resize(width, height);
+            return texture;
+        }
+
+        void release(Texture2D&& texture) {
+            TextureKey key{texture.storageWidth(), texture.storageHeight(), texture.requestedLevels(), texture.internalFormat(), texture.format(), texture.type()};
+            m_pool.release(key, std::move(texture));
+        }
+
+        void nextFrame(uint64_t maxIdleFrames = 3) { m_pool.nextFrame(maxIdleFrames); }
+        void clear() { m_pool.clear(); }
+        const PoolStats& stats() const { return m_pool.stats(); }
+
+    private:
+        ObjectPool<Texture2D, TextureKey> m_pool;
+    };
+
+    class RenderbufferPool {
+    public:
+        Renderbuffer acquire(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei samples = 0) {
+            Renderbuffer rbo = m_pool.acquire({internalFormat, width, height, samples}, [&] {
+                Renderbuffer created;
+                created.create();
+                if (samples > 0)
+                    created.storageMultisample(samples, internalFormat, width, height);
+                else
+                    created.storage(internalFormat, width, height);
+                return created;
+            });
+            rbo.resize(width, height);
+            return rbo;
+        }
+
+        void release(Renderbuffer&& rbo) {
+            RenderbufferKey key{rbo.internalFormat(), rbo.storageWidth(), rbo.storageHeight(), rbo.samples()};
+            m_pool.release(key, std::move(rbo));
+        }
+
+        void nextFrame(uint64_t maxIdleFrames = 3) { m_pool.nextFrame(maxIdleFrames); }
+        void clear() { m_pool.clear(); }
+        const PoolStats& stats() const { return m_pool.stats(); }
+
+    private:
+        ObjectPool<Renderbuffer, RenderbufferKey> m_pool;
+    };
+
+    // Only immutable (Buffer::storage) buffers are pooled; releasing any other buffer deletes it.
+    class BufferPool {
+    public:
+        Buffer acquire(GLenum target, GLsizeiptr size, GLbitfield flags) {
+            return m_pool.acquire({size, flags, target}, [&] {
+                Buffer buffer;
+                buffer.create(target);
+                buffer.storage(size, nullptr, flags);
+                return buffer;
+            });
+        }
+
+        void release(Buffer&& buffer) {
+            if (!buffer.immutable()) {
+                buffer.destroy();
+                return;
+            }
+            BufferKey key{buffer.size(), buffer.storageFlags(), buffer.target()};
+            m_pool.release(key, std::move(buffer));
+        }
+
+        void nextFrame(uint64_t maxIdleFrames = 3) { m_pool.nextFrame(maxIdleFrames); }
+        void clear() { m_pool.clear(); }
+        const PoolStats& stats() const { return m_pool.stats(); }
+
+    private:
+        ObjectPool<Buffer, BufferKey> m_pool;
+    };
+
+}
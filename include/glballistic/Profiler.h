@@ -0,0 +1,254 @@
+#pragma once
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+#ifdef GLBALLISTIC_PROFILE
+#define GLBALLISTIC_PROFILE_CONCAT_(a, b) a##b
+#define GLBALLISTIC_PROFILE_CONCAT(a, b) GLBALLISTIC_PROFILE_CONCAT_(a, b)
+#define GLBALLISTIC_PROFILE_ZONE(name) ::gl::ProfileScope GLBALLISTIC_PROFILE_CONCAT(glbProfileZone, __LINE__)(name)
+#else
+#define GLBALLISTIC_PROFILE_ZONE(name) ((void)0)
+#endif
+
+namespace gl {
+
+    struct ProfileZone {
+        const char* name{nullptr};
+        uint64_t frame{0};
+        GLuint depth{0};
+        uint64_t cpuBegin{0}, cpuEnd{0};
+        uint64_t gpuBegin{0}, gpuEnd{0};
+        bool gpuValid{false};
+    };
+
+    // CPU + GPU zone profiler. GPU time comes from GL_TIMESTAMP query pairs taken from a
+    // per-frame ring; a frame's queries are read back when the ring wraps around to it, and
+    // only if they are already available, so the profiler never stalls the pipeline.
+    // Zone names must outlive the profiler (string literals). All times are nanoseconds on
+    // the CPU clock; GPU timestamps are shifted onto it using the offset measured at init().
+    //
+    // With GLBALLISTIC_MULTI_CONTEXT the profiler state is per thread, like State's Context:
+    // each thread that owns a context calls init() for it, and zones on threads that never
+    // did (worker contexts) are ignored instead of touching another context's queries.
+    class Profiler {
+    public:
+        static void init(GLuint framesInFlight = 4, GLuint maxZonesPerFrame = 256) {
+            shutdown();
+
+            frames.resize(framesInFlight);
+            for (auto& frame : frames) {
+                frame.queries.resize(static_cast<size_t>(maxZonesPerFrame) * 2);
+                if (GLAD_GL_VERSION_4_5)
+                    glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+                else
+                    glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            gpuOffset = static_cast<int64_t>(cpuNow()) - gpuNow;
+            frameIndex = 0;
+            frameNumber = 0;
+            initialized = true;
+        }
+
+        static void shutdown() {
+            for (auto& frame : frames) {
+                if (!frame.queries.empty())
+                    glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+            frames.clear();
+            stack.clear();
+            initialized = false;
+        }
+
+        static void beginFrame() {
+            if (!initialized) return;
+            closeOpenZones();
+            frameIndex = (frameIndex + 1) % frames.size();
+            frameNumber++;
+            collect(frames[frameIndex]);
+            frames[frameIndex].zones.clear();
+            frames[frameIndex].lastQuery = 0;
+            frames[frameIndex].frame = frameNumber;
+        }
+
+        // Waits for the GPU and collects every outstanding frame; meant for shutdown or
+        // right before writing a trace.
+        static void finish() {
+            if (!initialized) return;
+            closeOpenZones();
+            glFinish();
+            for (size_t i = 1; i <= frames.size(); i++) {
+                Frame& frame = frames[(frameIndex + i) % frames.size()];
+                collect(frame);
+                frame.zones.clear();
+                frame.lastQuery = 0;
+            }
+        }
+
+        // Returns the frame the zone was opened in, which popZone() needs to tell a zone that
+        // beginFrame() already closed from one of the current frame.
+        static uint64_t pushZone(const char* name) {
+            if (!initialized) return 0;
+
+            Frame& frame = frames[frameIndex];
+            ProfileZone zone;
+            zone.name = name;
+            zone.frame = frame.frame;
+            zone.depth = static_cast<GLuint>(stack.size());
+            zone.cpuBegin = cpuNow();
+
+            size_t index = frame.zones.size();
+            if ((index + 1) * 2 <= frame.queries.size()) {
+                glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+                frame.lastQuery = frame.queries[index * 2];
+                zone.gpuValid = true;
+            }
+
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
+                glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+
+            frame.zones.push_back(zone);
+            stack.push_back(index);
+            return frameNumber;
+        }
+
+        static void popZone(uint64_t openedInFrame) {
+            if (!initialized) return;
+
+            // The debug group is still open even when beginFrame() has closed the zone.
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
+                glPopDebugGroup();
+
+            if (openedInFrame != frameNumber || stack.empty()) return;
+
+            Frame& frame = frames[frameIndex];
+            size_t index = stack.back();
+            stack.pop_back();
+            endZone(frame, frame.zones[index]);
+        }
+
+        static const std::vector<ProfileZone>& results() { return history; }
+        static void clearResults() { history.clear(); }
+        static void setHistoryLimit(size_t zones) { historyLimit = zones; }
+
+        // Writes the collected zones in the Chrome trace event format (also read by Perfetto),
+        // with CPU and GPU timings on separate tracks.
+        static bool writeChromeTrace(const char* path) {
+            std::ofstream out(path);
+            if (!out) return false;
+
+            out << std::fixed << std::setprecision(3);
+            out << "{\"traceEvents\":[";
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},";
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+            for (const auto& zone : history) {
+                writeEvent(out, zone, 1, zone.cpuBegin, zone.cpuEnd);
+                if (zone.gpuValid)
+                    writeEvent(out, zone, 2, zone.gpuBegin, zone.gpuEnd);
+            }
+
+            out << "]}\n";
+            return static_cast<bool>(out);
+        }
+
+    private:
+        struct Frame {
+            uint64_t frame{0};
+            GLuint lastQuery{0};
+            std::vector<GLuint> queries;
+            std::vector<ProfileZone> zones;
+        };
+
+        static uint64_t cpuNow() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static void endZone(Frame& frame, ProfileZone& zone) {
+            size_t index = static_cast<size_t>(&zone - frame.zones.data());
+            if (zone.gpuValid) {
+                glQueryCounter(frame.queries[index * 2 + 1], GL_TIMESTAMP);
+                frame.lastQuery = frame.queries[index * 2 + 1];
+            }
+            zone.cpuEnd = cpuNow();
+        }
+
+        // Ends the zones still open at a frame boundary, so every begin query has an end
+        // query and the frame's results can be read without waiting on a later frame.
+        static void closeOpenZones() {
+            Frame& frame = frames[frameIndex];
+            while (!stack.empty()) {
+                endZone(frame, frame.zones[stack.back()]);
+                stack.pop_back();
+            }
+        }
+
+        // Timestamps complete in submission order, so once the query issued last is
+        // available every other one is too and none of the reads below can block.
+        static void collect(Frame& frame) {
+            if (frame.zones.empty()) return;
+
+            GLint available = GL_TRUE;
+            if (frame.lastQuery)
+                glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+            for (size_t i = 0; i < frame.zones.size(); i++) {
+                ProfileZone zone = frame.zones[i];
+                if (zone.gpuValid && available) {
+                    GLuint64 begin = 0, end = 0;
+                    glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+                    glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+                    zone.gpuBegin = static_cast<uint64_t>(static_cast<int64_t>(begin) + gpuOffset);
+                    zone.gpuEnd = static_cast<uint64_t>(static_cast<int64_t>(end) + gpuOffset);
+                } else {
+                    zone.gpuValid = false;
+                }
+
+                if (history.size() < historyLimit)
+                    history.push_back(zone);
+            }
+        }
+
+        static void writeEvent(std::ofstream& out, const ProfileZone& zone, int tid, uint64_t begin, uint64_t end) {
+            out << ",{\"name\":\"" << (zone.name ? zone.name : "") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << static_cast<double>(begin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(end - begin) / 1000.0
+                << ",\"args\":{\"frame\":" << zone.frame << "}}";
+        }
+
+#ifdef GLBALLISTIC_MULTI_CONTEXT
+#define GLBALLISTIC_PROFILER_STATIC static inline thread_local
+#else
+#define GLBALLISTIC_PROFILER_STATIC static inline
+#endif
+        GLBALLISTIC_PROFILER_STATIC std::vector<Frame> frames;
+        GLBALLISTIC_PROFILER_STATIC std::vector<size_t> stack;
+        GLBALLISTIC_PROFILER_STATIC std::vector<ProfileZone> history;
+        GLBALLISTIC_PROFILER_STATIC size_t historyLimit = 1 << 20;
+        GLBALLISTIC_PROFILER_STATIC size_t frameIndex = 0;
+        GLBALLISTIC_PROFILER_STATIC uint64_t frameNumber = 0;
+        GLBALLISTIC_PROFILER_STATIC int64_t gpuOffset = 0;
+        GLBALLISTIC_PROFILER_STATIC bool initialized = false;
+#undef GLBALLISTIC_PROFILER_STATIC
+    };
+
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const char* name) : m_frame(Profiler::pushZone(name)) {}
+        ~ProfileScope() { Profiler::popZone(m_frame); }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        uint64_t m_frame;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/Shader.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    struct ShaderSource {
+        GLenum type;
+        const char* source;
+    };
+
+    // Caches linked program binaries in memory and, when given a directory, on disk. Entries
+    // are keyed by a hash of every stage source together with the GL vendor, renderer and
+    // version strings, so a driver update simply misses instead of loading a stale binary.
+    // Binaries the driver rejects anyway are dropped and the program is rebuilt from source.
+    //
+    // An async Shader (Shader::setAsync) is left pending on a miss: build() returns at once
+    // and its binary is stored by a later poll() once the driver has finished linking. Such a
+    // shader must stay at the same address until then, or be handed to cancel().
+    class ProgramCache {
+    public:
+        ProgramCache() = default;
+        explicit ProgramCache(std::filesystem::path directory) { setDirectory(std::move(directory)); }
+
+        ProgramCache(const ProgramCache&) = delete;
+        ProgramCache& operator=(const ProgramCache&) = delete;
+
+        void setDirectory(std::filesystem::path directory) {
+            m_directory = std::move(directory);
+            if (!m_directory.empty()) {
+                std::error_code ec;
+                std::filesystem::create_directories(m_directory, ec);
+            }
+        }
+
+        const std::filesystem::path& directory() const { return m_directory; }
+
+        // Creates and links the program. Returns false only if linking from source fails,
+        // which for an async shader is not known until Shader::wait().
+        bool build(Shader& shader, std::span<const ShaderSource> sources) {
+            shader.create();
+            if (!supported()) return compile(shader, sources);
+
+            uint64_t key = hash(sources);
+            Binary* binary = find(key);
+            if (binary) {
+                if (shader.loadBinary(binary->format, binary->data.data(), static_cast<GLsizei>(binary->data.size()))) {
+                    m_hits++;
+                    return true;
+                }
+                m_rejected++;
+                m_memory.erase(key);
+                if (!m_directory.empty()) {
+                    std::error_code ec;
+                    std::filesystem::remove(path(key), ec);
+                }
+            }
+
+            m_misses++;
+            shader.setBinaryRetrievable();
+            if (!compile(shader, sources)) return false;
+
+            if (shader.pending())
+                m_pending.push_back({&shader, key});
+            else
+                store(key, shader);
+            return true;
+        }
+
+        bool build(Shader& shader, std::initializer_list<ShaderSource> sources) {
+            return build(shader, std::span<const ShaderSource>(sources.begin(), sources.size()));
+        }
+
+        // Stores the binaries of pending shaders whose link has finished; never blocks when
+        // KHR_parallel_shader_compile is available. Returns how many are still pending.
+        size_t poll() {
+            std::erase_if(m_pending, [&](const Pending& p) {
+                if (!p.shader->ready()) return false;
+                if (p.shader->wait())
+                    store(p.key, *p.shader);
+                return true;
+            });
+            return m_pending.size();
+        }
+
+        // Stops tracking a pending shader, e.g. before it is destroyed or moved.
+        void cancel(const Shader& shader) {
+            std::erase_if(m_pending, [&](const Pending& p) { return p.shader == &shader; });
+        }
+
+        void clear() { m_memory.clear(); }
+
+        uint64_t hits() const { return m_hits; }
+        uint64_t misses() const { return m_misses; }
+        uint64_t rejected() const { return m_rejected; }
+        size_t size() const { return m_memory.size(); }
+        size_t pending() const { return m_pending.size(); }
+
+    private:
+        static constexpr uint32_t Magic = 0x50424C47; // "GLBP"
+        static constexpr uint32_t Version = 1;
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t key;
+            uint32_t format;
+            uint32_t size;
+        };
+
+        struct Binary {
+            GLenum format{0};
+            std::vector<unsigned char> data;
+        };
+
+        struct Pending {
+            Shader* shader;
+            uint64_t key;
+        };
+
+        std::filesystem::path m_directory;
+        std::unordered_map<uint64_t, Binary> m_memory;
+        std::vector<Pending> m_pending;
+        uint64_t m_hits{0};
+        uint64_t m_misses{0};
+        uint64_t m_rejected{0};
+
+        static bool supported() {
+            if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) return false;
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            return formats > 0;
+        }
+
+        // Leaves an async shader pending instead of waiting for the driver.
+        static bool compile(Shader& shader, std::span<const ShaderSource> sources) {
+            for (const auto& stage : sources)
+                shader.attachShader(stage.type, stage.source);
+            return shader.link();
+        }
+
+        void store(uint64_t key, const Shader& shader) {
+            Binary fresh;
+            if (shader.getBinary(fresh.format, fresh.data)) {
+                write(key, fresh);
+                m_memory[key] = std::move(fresh);
+            }
+        }
+
+        static void mix(uint64_t& h, const void* data, size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                h ^= bytes[i];
+                h *= 1099511628211ull;
+            }
+        }
+
+        static void mix(uint64_t& h, const char* str) {
+            if (str) mix(h, str, std::strlen(str) + 1);
+        }
+
+        static uint64_t hash(std::span<const ShaderSource> sources) {
+            uint64_t h = 14695981039346656037ull;
+            mix(h, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+            mix(h, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+            mix(h, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+            for (const auto& stage : sources) {
+                mix(h, &stage.type, sizeof(stage.type));
+                mix(h, stage.source);
+            }
+            return h;
+        }
+
+        std::filesystem::path path(uint64_t key) const {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.glbp", static_cast<unsigned long long>(key));
+            return m_directory / name;
+        }
+
+        Binary* find(uint64_t key) {
+            auto it = m_memory.find(key);
+            if (it != m_memory.end()) return &it->second;
+            if (m_directory.empty()) return nullptr;
+
+            std::ifstream in(path(key), std::ios::binary);
+            if (!in) return nullptr;
+
+            Header header{};
+            in.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!in || header.magic != Magic || header.version != Version || header.key != key || header.size == 0)
+                return nullptr;
+
+            Binary binary;
+            binary.format = header.format;
+            binary.data.resize(header.size);
+            in.read(reinterpret_cast<char*>(binary.data.data()), header.size);
+            if (!in) return nullptr;
+
+            return &(m_memory[key] = std::move(binary));
+        }
+
+        void write(uint64_t key, const Binary& binary) const {
+            if (m_directory.empty()) return;
+
+            // Write to a temporary file first so a crash never leaves a truncated entry behind.
+            std::filesystem::path target = path(key);
+            std::filesystem::path temp = target;
+            temp += ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                if (!out) return;
+                Header header{Magic, Version, key, binary.format, static_cast<uint32_t>(binary.data.size())};
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char*>(binary.data.data()), static_cast<std::streamsize>(binary.data.size()));
+                if (!out) return;
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(temp, target, ec);
+            if (ec) std::filesystem::remove(temp, ec);
+        }
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,251 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/Fence.h>
+#include <glballistic/Texture2D.h>
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    class ReadbackPool;
+
+    struct ReadbackBuffer {
+        Buffer buffer;
+        unsigned char* mapped{nullptr};
+        bool persistent{false};
+    };
+
+    // An in-flight transfer into a pooled pixel-pack buffer. Poll ready() each frame and call
+    // data() once it returns true; data() on an unfinished transfer blocks until it lands.
+    // The bytes are read straight from the mapped buffer and stay valid until release().
+    class ReadbackTicket {
+    public:
+        ReadbackTicket() = default;
+        ~ReadbackTicket() { release(); }
+
+        ReadbackTicket(const ReadbackTicket&) = delete;
+        ReadbackTicket& operator=(const ReadbackTicket&) = delete;
+
+        ReadbackTicket(ReadbackTicket&& other) noexcept { *this = std::move(other); }
+        ReadbackTicket& operator=(ReadbackTicket&& other) noexcept {
+            if (this != &other) {
+                release();
+                m_pool = other.m_pool;
+                m_buffer = std::move(other.m_buffer);
+                m_fence = std::move(other.m_fence);
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_rowPitch = other.m_rowPitch;
+                m_size = other.m_size;
+                other.m_pool = nullptr;
+                other.m_size = 0;
+            }
+            return *this;
+        }
+
+        bool valid() const { return m_buffer != nullptr; }
+        bool ready() { return m_buffer && m_fence.signaled(); }
+        bool wait(GLuint64 timeout = GL_TIMEOUT_IGNORED) { return m_buffer && m_fence.wait(timeout); }
+
+        std::span<const unsigned char> data() {
+            if (!m_buffer) return {};
+            m_fence.wait();
+
+            if (!m_buffer->mapped)
+                m_buffer->mapped = static_cast<unsigned char*>(m_buffer->buffer.mapRange(0, m_size, GL_MAP_READ_BIT));
+            return {m_buffer->mapped, static_cast<size_t>(m_size)};
+        }
+
+        GLsizei width() const { return m_width; }
+        GLsizei height() const { return m_height; }
+        GLsizeiptr rowPitch() const { return m_rowPitch; }
+        GLsizeiptr size() const { return m_size; }
+
+        void release();
+
+    private:
+        friend class ReadbackPool;
+
+        ReadbackPool* m_pool{nullptr};
+        std::unique_ptr<ReadbackBuffer> m_buffer;
+        Fence m_fence;
+        GLsizei m_width{0}, m_height{0};
+        GLsizeiptr m_rowPitch{0};
+        GLsizeiptr m_size{0};
+    };
+
+    // Recycles pixel-pack buffers between readbacks. Tickets hold a pointer back to the pool,
+    // so the pool has to outlive them.
+    class ReadbackPool {
+    public:
+        ReadbackPool() = default;
+        ~ReadbackPool() { destroy(); }
+
+        ReadbackPool(const ReadbackPool&) = delete;
+        ReadbackPool& operator=(const ReadbackPool&) = delete;
+
+        void destroy() {
+            for (auto& buffer : m_free)
+                unmap(*buffer);
+            m_free.clear();
+
+            if (m_readFramebuffer) {
+                glDeleteFramebuffers(1, &m_readFramebuffer);
+                m_readFramebuffer = 0;
+            }
+        }
+
+        ReadbackTicket read(const Texture2D& texture, GLint level = 0) {
+            return read(texture, level, 0, 0, texture.levelWidth(level), texture.levelHeight(level));
+        }
+
+        // Returns an invalid ticket when the texture can only be read through a framebuffer and its
+        // format cannot be attached to one, e.g. a compressed sub-rectangle without
+        // ARB_get_texture_sub_image.
+        ReadbackTicket read(const Texture2D& texture, GLint level, GLint x, GLint y, GLsizei width, GLsizei height) {
+            bool subImage = GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_get_texture_sub_image;
+            // glGetTexImage returns the whole level of the storage, which may be larger than the texture's size.
+            bool fullLevel = x == 0 && y == 0 && width == std::max(1, texture.storageWidth() >> level) && height == std::max(1, texture.storageHeight() >> level);
+            GLenum attachment = subImage || fullLevel ? GL_NONE : readAttachment(texture.internalFormat(), texture.format());
+            if (!subImage && !fullLevel && attachment == GL_NONE) return {};
+
+            ReadbackTicket ticket;
+            ticket.m_pool = this;
+            ticket.m_width = width;
+            ticket.m_height = height;
+            ticket.m_rowPitch = (static_cast<GLsizeiptr>(width) * PixelSize(texture.format(), texture.type()) + 3) & ~GLsizeiptr(3);
+            ticket.m_size = ticket.m_rowPitch * height;
+            ticket.m_buffer = acquire(ticket.m_size);
+
+            State::syncTexture(texture.get(), "ReadbackPool::read", GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+            State::bindBuffer(GL_PIXEL_PACK_BUFFER, ticket.m_buffer->buffer.get());
+
+            if (subImage) {
+                glGetTextureSubImage(texture.get(), level, x, y, 0, width, height, 1,
+                                     texture.format(), texture.type(), static_cast<GLsizei>(ticket.m_size), nullptr);
+            } else if (fullLevel) {
+                texture.bind();
+                glGetTexImage(GL_TEXTURE_2D, level, texture.format(), texture.type(), nullptr);
+            } else {
+                if (!m_readFramebuffer) glGenFramebuffers(1, &m_readFramebuffer);
+                GLuint previous = State::boundFramebuffer(GL_READ_FRAMEBUFFER);
+                State::bindFramebuffer(m_readFramebuffer, GL_READ_FRAMEBUFFER);
+                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture.get(), level);
+                glReadBuffer(attachment == GL_COLOR_ATTACHMENT0 ? GL_COLOR_ATTACHMENT0 : GL_NONE);
+                glReadPixels(x, y, width, height, texture.format(), texture.type(), nullptr);
+                glFramebufferTexture2D(GL_READ_FRAMEBUFFER, attachment, GL_TEXTURE_2D, 0, 0);
+                State::bindFramebuffer(previous, GL_READ_FRAMEBUFFER);
+            }
+
+            State::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            ticket.m_fence.create();
+            return ticket;
+        }
+
+        size_t pooled() const { return m_free.size(); }
+
+    private:
+        friend class ReadbackTicket;
+
+        std::vector<std::unique_ptr<ReadbackBuffer>> m_free;
+        GLuint m_readFramebuffer{0};
+
+        std::unique_ptr<ReadbackBuffer> acquire(GLsizeiptr size) {
+            auto best = m_free.end();
+            for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+                if ((*it)->buffer.size() >= size && (best == m_free.end() || (*it)->buffer.size() < (*best)->buffer.size()))
+                    best = it;
+            }
+
+            if (best != m_free.end()) {
+                auto buffer = std::move(*best);
+                m_free.erase(best);
+                return buffer;
+            }
+
+            GLsizeiptr capacity = 4096;
+            while (capacity < size) capacity *= 2;
+
+            auto buffer = std::make_unique<ReadbackBuffer>();
+            buffer->buffer.create(GL_PIXEL_PACK_BUFFER);
+            if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+                GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                buffer->buffer.storage(capacity, nullptr, flags);
+                buffer->mapped = static_cast<unsigned char*>(buffer->buffer.mapRange(0, capacity, flags));
+                buffer->persistent = true;
+            } else {
+                buffer->buffer.data(capacity, nullptr, GL_STREAM_READ);
+            }
+            return buffer;
+        }
+
+        void recycle(std::unique_ptr<ReadbackBuffer> buffer) {
+            if (!buffer->persistent && buffer->mapped) {
+                buffer->buffer.unmap();
+                buffer->mapped = nullptr;
+            }
+            m_free.push_back(std::move(buffer));
+        }
+
+        // The attachment point glReadPixels can read internalFormat through as format, or
+        // GL_NONE when the pair cannot be read back from a framebuffer.
+        static GLenum readAttachment(GLenum internalFormat, GLenum format) {
+            switch (internalFormat) {
+                case GL_DEPTH_COMPONENT16:
+                case GL_DEPTH_COMPONENT24:
+                case GL_DEPTH_COMPONENT32:
+                case GL_DEPTH_COMPONENT32F:
+                    return format == GL_DEPTH_COMPONENT ? GL_DEPTH_ATTACHMENT : GL_NONE;
+                case GL_DEPTH24_STENCIL8:
+                case GL_DEPTH32F_STENCIL8:
+                    return format == GL_DEPTH_STENCIL || format == GL_DEPTH_COMPONENT || format == GL_STENCIL_INDEX ? GL_DEPTH_STENCIL_ATTACHMENT : GL_NONE;
+                case GL_STENCIL_INDEX8:
+                    return format == GL_STENCIL_INDEX ? GL_STENCIL_ATTACHMENT : GL_NONE;
+                case GL_COMPRESSED_RED_RGTC1:
+                case GL_COMPRESSED_SIGNED_RED_RGTC1:
+                case GL_COMPRESSED_RG_RGTC2:
+                case GL_COMPRESSED_SIGNED_RG_RGTC2:
+                case GL_COMPRESSED_RGBA_BPTC_UNORM:
+                case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+                case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+                case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                case GL_COMPRESSED_RGB8_ETC2:
+                case GL_COMPRESSED_SRGB8_ETC2:
+                case GL_COMPRESSED_RGBA8_ETC2_EAC:
+                case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+                case GL_COMPRESSED_R11_EAC:
+                case GL_COMPRESSED_SIGNED_R11_EAC:
+                case GL_COMPRESSED_RG11_EAC:
+                case GL_COMPRESSED_SIGNED_RG11_EAC:
+                    return GL_NONE;
+                default:
+                    return format == GL_DEPTH_COMPONENT || format == GL_DEPTH_STENCIL || format == GL_STENCIL_INDEX ? GL_NONE : GL_COLOR_ATTACHMENT0;
+            }
+        }
+
+        static void unmap(ReadbackBuffer& buffer) {
+            if (buffer.mapped) buffer.buffer.unmap();
+            buffer.mapped = nullptr;
+        }
+    };
+
+    inline void ReadbackTicket::release() {
+        if (!m_buffer) return;
+        m_fence.destroy();
+        if (m_pool)
+            m_pool->recycle(std::move(m_buffer));
+        m_buffer.reset();
+        m_pool = nullptr;
+    }
+
+}
\ No newline at end of file
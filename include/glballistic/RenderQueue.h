@@ -0,0 +1,293 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/RenderState.h>
+#include <glballistic/State.h>
+#include <glballistic/Profiler.h>
+#include <glballistic/IndirectCommandBuffer.h>
+#include <glballistic/Shader.h>
+#include <glballistic/VertexArray.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gl {
+
+    struct TextureBinding {
+        GLenum target{GL_TEXTURE_2D};
+        GLuint id{0};
+
+        bool operator==(const TextureBinding&) const = default;
+    };
+
+    // One draw plus the state it needs. shader, pipeline and vertexArray are borrowed and must
+    // stay alive until the queue is flushed; a null pipeline leaves render state untouched.
+    // textures[i] is bound to unit i; entries with id 0 leave their unit alone.
+    struct DrawPacket {
+        static constexpr size_t MaxTextures = 4;
+
+        const Shader* shader{nullptr};
+        const PipelineState* pipeline{nullptr};
+        const VertexArray* vertexArray{nullptr};
+        std::array<TextureBinding, MaxTextures> textures{};
+
+        GLenum mode{GL_TRIANGLES};
+        bool indexed{true};
+        GLuint count{0};
+        GLuint first{0};            // first vertex, or first index when indexed
+        GLint baseVertex{0};
+        GLuint instanceCount{1};
+        GLuint baseInstance{0};
+
+        GLuint pass{0};
+        float depth{0.0f};          // view depth normalized to [0, 1]
+        bool backToFront{false};    // sort by depth before state, for blended passes
+
+        uint64_t key{0};
+
+        bool sameState(const DrawPacket& other) const {
+            return shader == other.shader && vertexArray == other.vertexArray && textures == other.textures
+                && mode == other.mode && indexed == other.indexed
+                && (pipeline == other.pipeline || (pipeline && other.pipeline && *pipeline == *other.pipeline));
+        }
+    };
+
+    // Packs a packet's state into a key whose ascending order groups draws by pass, then
+    // program, render state, vertex array and textures, and finally front-to-back depth.
+    // Back-to-front packets put inverted depth right after the pass instead. Object names are
+    // folded into their fields, so equal keys only mean "probably the same state"; merging in
+    // RenderQueue compares the packets themselves.
+    struct SortKey {
+        static constexpr int PassBits = 6, ProgramBits = 12, StateBits = 12, VertexArrayBits = 10, TextureBits = 10, DepthBits = 14;
+        static_assert(PassBits + ProgramBits + StateBits + VertexArrayBits + TextureBits + DepthBits == 64);
+
+        static uint64_t make(const DrawPacket& p) {
+            uint64_t pass = field(p.pass, PassBits);
+            uint64_t program = field(p.shader ? p.shader->get() : 0, ProgramBits);
+            uint64_t state = field(p.pipeline ? p.pipeline->hash() : 0, StateBits);
+            uint64_t vao = field(p.vertexArray ? p.vertexArray->get() : 0, VertexArrayBits);
+            uint64_t textures = field(textureHash(p.textures), TextureBits);
+            uint64_t depth = quantize(p.depth);
+
+            uint64_t stateBits = (((program << StateBits | state) << VertexArrayBits | vao) << TextureBits) | textures;
+            constexpr int StateWidth = ProgramBits + StateBits + VertexArrayBits + TextureBits;
+
+            if (p.backToFront)
+                return (pass << (64 - PassBits)) | ((((1ull << DepthBits) - 1) - depth) << StateWidth) | stateBits;
+            return (pass << (64 - PassBits)) | (stateBits << DepthBits) | depth;
+        }
+
+        static uint64_t field(uint64_t value, int bits) {
+            return (value ^ (value >> bits) ^ (value >> (2 * bits))) & ((1ull << bits) - 1);
+        }
+
+        static uint64_t quantize(float depth) {
+            float clamped = std::clamp(depth, 0.0f, 1.0f);
+            return static_cast<uint64_t>(clamped * static_cast<float>((1u << DepthBits) - 1));
+        }
+
+        static uint64_t textureHash(const std::array<TextureBinding, DrawPacket::MaxTextures>& textures) {
+            uint64_t h = 0;
+            for (const auto& t : textures)
+                h = h * 31 + t.id;
+            return h;
+        }
+    };
+
+    // Packets recorded without touching GL, so each worker thread can fill its own list and
+    // hand it to RenderQueue::append() on the GL thread.
+    class DrawList {
+    public:
+        void push(DrawPacket packet) {
+            packet.key = SortKey::make(packet);
+            m_packets.push_back(packet);
+        }
+
+        void clear() { m_packets.clear(); }
+        void reserve(size_t count) { m_packets.reserve(count); }
+
+        std::span<const DrawPacket> packets() const { return m_packets; }
+        size_t size() const { return m_packets.size(); }
+        bool empty() const { return m_packets.empty(); }
+
+    private:
+        std::vector<DrawPacket> m_packets;
+    };
+
+    // Sorts a frame's packets by SortKey and replays them through State so that consecutive
+    // draws share as much bound state as possible. Runs of packets with the same state become
+    // one multi-draw-indirect call; within a run, packets that draw the same range with
+    // adjacent baseInstance values are merged into one instanced command.
+    //
+    // Every draw goes through the indirect path, so this needs GL 4.0; non-zero baseInstance
+    // values need GL 4.2.
+    class RenderQueue {
+    public:
+        RenderQueue() = default;
+
+        RenderQueue(const RenderQueue&) = delete;
+        RenderQueue& operator=(const RenderQueue&) = delete;
+
+        void create(GLsizei capacity = 1024) {
+            m_arrays.create(capacity);
+            m_elements.create(capacity);
+        }
+
+        void destroy() {
+            m_arrays.destroy();
+            m_elements.destroy();
+            clear();
+        }
+
+        void push(DrawPacket packet) {
+            packet.key = SortKey::make(packet);
+            m_packets.push_back(packet);
+        }
+
+        void append(const DrawList& list) {
+            m_packets.insert(m_packets.end(), list.packets().begin(), list.packets().end());
+        }
+
+        void append(std::span<const DrawList> lists) {
+            size_t total = m_packets.size();
+            for (const auto& list : lists) total += list.size();
+            m_packets.reserve(total);
+            for (const auto& list : lists) append(list);
+        }
+
+        void clear() {
+            m_packets.clear();
+            m_order.clear();
+            m_batches.clear();
+        }
+
+        // Sorts, submits and clears. Returns the number of multi-draw calls issued. A queue
+        // that was never created gets its command buffers here, at the default capacity.
+        size_t flush() {
+            GLBALLISTIC_PROFILE_ZONE("RenderQueue::flush");
+            create();
+            sort();
+            build();
+
+            m_arrays.upload();
+            m_elements.upload();
+
+            for (const Batch& batch : m_batches) {
+                const DrawPacket& p = m_packets[batch.packet];
+                bindState(p);
+                GLintptr offset = static_cast<GLintptr>(batch.first) * (p.indexed ? DrawElementsCommandBuffer::Stride : DrawArraysCommandBuffer::Stride);
+                if (p.indexed)
+                    p.vertexArray->multiDrawElementsIndirect(p.mode, m_elements.buffer(), offset, batch.count);
+                else
+                    p.vertexArray->multiDrawArraysIndirect(p.mode, m_arrays.buffer(), offset, batch.count);
+            }
+
+            size_t calls = m_batches.size();
+            clear();
+            return calls;
+        }
+
+        std::span<const DrawPacket> packets() const { return m_packets; }
+        size_t size() const { return m_packets.size(); }
+
+    private:
+        struct Entry {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        struct Batch {
+            uint32_t packet;
+            GLuint first;
+            GLsizei count;
+        };
+
+        std::vector<DrawPacket> m_packets;
+        std::vector<Entry> m_order;
+        std::vector<Entry> m_scratch;
+        std::vector<Batch> m_batches;
+        DrawArraysCommandBuffer m_arrays;
+        DrawElementsCommandBuffer m_elements;
+
+        // LSD radix sort on 8-bit digits; stable, and digits every key shares are skipped,
+        // which is common since the pass and program bits vary little within a frame.
+        void sort() {
+            m_order.resize(m_packets.size());
+            m_scratch.resize(m_packets.size());
+            for (size_t i = 0; i < m_packets.size(); i++)
+                m_order[i] = {m_packets[i].key, static_cast<uint32_t>(i)};
+            radixSort(m_order, m_scratch);
+        }
+
+        static void radixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch) {
+            if (entries.size() < 2) return;
+
+            uint64_t same = ~0ull, first = entries[0].key;
+            for (const Entry& e : entries) same &= ~(e.key ^ first);
+
+            for (int shift = 0; shift < 64; shift += 8) {
+                if (((same >> shift) & 0xFF) == 0xFF) continue;
+
+                std::array<size_t, 257> offsets{};
+                for (const Entry& e : entries) offsets[((e.key >> shift) & 0xFF) + 1]++;
+                for (size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i - 1];
+                for (const Entry& e : entries) scratch[offsets[(e.key >> shift) & 0xFF]++] = e;
+                entries.swap(scratch);
+            }
+        }
+
+        void build() {
+            m_arrays.clear();
+            m_elements.clear();
+            m_batches.clear();
+
+            const DrawPacket* last = nullptr;
+            for (const Entry& entry : m_order) {
+                uint32_t index = entry.index;
+                const DrawPacket& p = m_packets[index];
+                if (!p.vertexArray || p.count == 0 || p.instanceCount == 0) continue;
+
+                if (!last || !last->sameState(p)) {
+                    GLuint first = static_cast<GLuint>(p.indexed ? m_elements.size() : m_arrays.size());
+                    m_batches.push_back({index, first, 0});
+                } else if (merge(*last, p)) {
+                    last = &p;
+                    continue;
+                }
+
+                if (p.indexed)
+                    m_elements.push({p.count, p.instanceCount, p.first, p.baseVertex, p.baseInstance});
+                else
+                    m_arrays.push({p.count, p.instanceCount, p.first, p.baseInstance});
+                m_batches.back().count++;
+                last = &p;
+            }
+        }
+
+        // Extends the previous command by p's instances when both draw the same range and p
+        // starts where the previous command's instances end.
+        bool merge(const DrawPacket& previous, const DrawPacket& p) {
+            if (previous.count != p.count || previous.first != p.first || previous.baseVertex != p.baseVertex) return false;
+
+            if (p.indexed) {
+                auto& cmd = m_elements[m_elements.size() - 1];
+                if (cmd.baseInstance + cmd.instanceCount != p.baseInstance) return false;
+                cmd.instanceCount += p.instanceCount;
+            } else {
+                auto& cmd = m_arrays[m_arrays.size() - 1];
+                if (cmd.baseInstance + cmd.instanceCount != p.baseInstance) return false;
+                cmd.instanceCount += p.instanceCount;
+            }
+            return true;
+        }
+
+        static void bindState(const DrawPacket& p) {
+            if (p.shader) p.shader->use();
+            if (p.pipeline) State::apply(*p.pipeline);
+            for (GLuint unit = 0; unit < DrawPacket::MaxTextures; unit++)
+                if (p.textures[unit].id) State::bindTexture(unit, p.textures[unit].target, p.textures[unit].id);
+        }
+    };
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace gl {
+
+    struct BlendState {
+        GLenum srcRGB{GL_ONE}, dstRGB{GL_ZERO};
+        GLenum srcAlpha{GL_ONE}, dstAlpha{GL_ZERO};
+        GLenum opRGB{GL_FUNC_ADD}, opAlpha{GL_FUNC_ADD};
+
+        bool operator==(const BlendState&) const = default;
+    };
+
+    struct DepthState {
+        GLenum func{GL_LESS};
+        GLuint write{GL_TRUE};
+
+        bool operator==(const DepthState&) const = default;
+    };
+
+    struct StencilState {
+        GLenum func{GL_ALWAYS};
+        GLint ref{0};
+        GLuint readMask{~0u};
+        GLuint writeMask{~0u};
+        GLenum sfail{GL_KEEP}, dpfail{GL_KEEP}, dppass{GL_KEEP};
+
+        bool operator==(const StencilState&) const = default;
+    };
+
+    struct RasterState {
+        GLenum cullFace{GL_BACK};
+        GLenum frontFace{GL_CCW};
+        GLenum polygonMode{GL_FILL};
+        GLuint colorMask{0xF};
+        GLfloat offsetFactor{0.0f}, offsetUnits{0.0f};
+
+        bool operator==(const RasterState&) const = default;
+    };
+
+    struct Rect {
+        GLint x{0}, y{0};
+        GLsizei width{0}, height{0};
+
+        bool empty() const { return width <= 0 || height <= 0; }
+        bool operator==(const Rect&) const = default;
+    };
+
+    // Every member is a 32-bit value so the block has no padding and can be hashed bytewise.
+    // viewport and scissor are opt-in: left empty, applying the state keeps the current
+    // rectangles, so one pipeline can be reused across render targets of different sizes.
+    struct RenderState {
+        static constexpr GLuint Blend             = 1u << 0;
+        static constexpr GLuint DepthTest         = 1u << 1;
+        static constexpr GLuint StencilTest       = 1u << 2;
+        static constexpr GLuint CullFace          = 1u << 3;
+        static constexpr GLuint ScissorTest       = 1u << 4;
+        static constexpr GLuint PolygonOffsetFill = 1u << 5;
+        static constexpr GLuint Multisample       = 1u << 6;
+        static constexpr GLuint FramebufferSRGB   = 1u << 7;
+        static constexpr GLuint EnableCount       = 8;
+
+        GLuint enables{Multisample};
+        BlendState blend;
+        DepthState depth;
+        StencilState stencil;
+        RasterState raster;
+        Rect viewport;
+        Rect scissor;
+
+        bool operator==(const RenderState&) const = default;
+
+        size_t hash() const {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(this);
+            uint64_t h = 14695981039346656037ull;
+            for (size_t i = 0; i < sizeof(RenderState); i++) {
+                h ^= bytes[i];
+                h *= 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+
+        static constexpr GLenum capability(GLuint bit) {
+            switch (bit) {
+                case Blend:             return GL_BLEND;
+                case DepthTest:         return GL_DEPTH_TEST;
+                case StencilTest:       return GL_STENCIL_TEST;
+                case CullFace:          return GL_CULL_FACE;
+                case ScissorTest:       return GL_SCISSOR_TEST;
+                case PolygonOffsetFill: return GL_POLYGON_OFFSET_FILL;
+                case Multisample:       return GL_MULTISAMPLE;
+                case FramebufferSRGB:   return GL_FRAMEBUFFER_SRGB;
+                default:                return 0;
+            }
+        }
+
+        static constexpr GLuint enableBit(GLenum cap) {
+            switch (cap) {
+                case GL_BLEND:               return Blend;
+                case GL_DEPTH_TEST:          return DepthTest;
+                case GL_STENCIL_TEST:        return StencilTest;
+                case GL_CULL_FACE:           return CullFace;
+                case GL_SCISSOR_TEST:        return ScissorTest;
+                case GL_POLYGON_OFFSET_FILL: return PolygonOffsetFill;
+                case GL_MULTISAMPLE:         return Multisample;
+                case GL_FRAMEBUFFER_SRGB:    return FramebufferSRGB;
+                default:                     return 0;
+            }
+        }
+
+        // Compares unequal to anything the driver could hold (enums are ~0, floats are NaN),
+        // so the next diff against it issues every field.
+        static RenderState unknown() {
+            RenderState rs;
+            std::memset(static_cast<void*>(&rs), 0xFF, sizeof(rs));
+            return rs;
+        }
+    };
+
+    static_assert(sizeof(RenderState) == 30 * sizeof(GLuint), "RenderState must stay padding-free for hashing");
+
+    class PipelineState {
+    public:
+        PipelineState() : m_hash(m_desc.hash()) {}
+        explicit PipelineState(const RenderState& desc) : m_desc(desc), m_hash(desc.hash()) {}
+
+        const RenderState& desc() const { return m_desc; }
+        size_t hash() const { return m_hash; }
+
+        bool operator==(const PipelineState& other) const { return m_hash == other.m_hash && m_desc == other.m_desc; }
+
+    private:
+        RenderState m_desc;
+        size_t m_hash;
+    };
+
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <glballistic/State.h>
+#include <glballistic/Misc.h>
 #include <utility>
 #include <vector>
 
@@ -21,11 +22,15 @@ namespace gl {
                 m_id = other.m_id;
                 m_width = other.m_width;
                 m_height = other.m_height;
+                m_storageWidth = other.m_storageWidth;
+                m_storageHeight = other.m_storageHeight;
                 m_samples = other.m_samples;
                 m_internalFormat = other.m_internalFormat;
                 other.m_id = 0;
                 other.m_width = 0;
                 other.m_height = 0;
+                other.m_storageWidth = 0;
+                other.m_storageHeight = 0;
                 other.m_samples = 0;
                 other.m_internalFormat = 0;
             }
@@ -34,10 +39,7 @@ namespace gl {
 
         void create() {
             if (m_id) return;
-            if (GLAD_GL_VERSION_4_5)
-                glCreateRenderbuffers(1, &m_id);
-            else
-                glGenRenderbuffers(1, &m_id);
+            m_id = State::names().renderbuffers.acquire();
         }
 
         void destroy() {
@@ -46,6 +48,8 @@ namespace gl {
             m_id = 0;
             m_width = 0;
             m_height = 0;
+            m_storageWidth = 0;
+            m_storageHeight = 0;
             m_samples = 0;
             m_internalFormat = 0;
         }
@@ -58,8 +62,8 @@ namespace gl {
 
         void storage(GLenum internalFormat, GLsizei width, GLsizei height) {
             m_internalFormat = internalFormat;
-            m_width = width;
-            m_height = height;
+            m_width = m_storageWidth = width;
+            m_height = m_storageHeight = height;
             m_samples = 0;
 
             if (GLAD_GL_VERSION_4_5)
@@ -72,8 +76,8 @@ namespace gl {
 
         void storageMultisample(GLsizei samples, GLenum internalFormat, GLsizei width, GLsizei height) {
             m_internalFormat = internalFormat;
-            m_width = width;
-            m_height = height;
+            m_width = m_storageWidth = width;
+            m_height = m_storageHeight = height;
             m_samples = samples;
 
             if (GLAD_GL_VERSION_4_5)
@@ -88,13 +92,24 @@ namespace gl {
             glFramebufferRenderbuffer(target, attachment, GL_RENDERBUFFER, m_id);
         }
 
-        void resize(GLsizei width, GLsizei height) {
-            if (!m_id) return;
+        // Same capacity policy as Texture2D::resize: storage is respecified only when it has
+        // to grow or is less than half used, and the logical size is a region of it.
+        bool resize(GLsizei width, GLsizei height) {
+            if (!m_id) return false;
+
+            GLsizei storageWidth = TargetCapacity(m_storageWidth, width);
+            GLsizei storageHeight = TargetCapacity(m_storageHeight, height);
+            bool reallocate = storageWidth != m_storageWidth || storageHeight != m_storageHeight;
+            if (reallocate) {
+                if (m_samples > 0)
+                    storageMultisample(m_samples, m_internalFormat, storageWidth, storageHeight);
+                else
+                    storage(m_internalFormat, storageWidth, storageHeight);
+            }
 
-            if (m_samples > 0)
-                storageMultisample(m_samples, m_internalFormat, width, height);
-            else
-                storage(m_internalFormat, width, height);
+            m_width = width;
+            m_height = height;
+            return reallocate;
         }
 
         void label(const char* name) {
@@ -104,6 +119,8 @@ namespace gl {
 
         GLsizei width() const { return m_width; }
         GLsizei height() const { return m_height; }
+        GLsizei storageWidth() const { return m_storageWidth; }
+        GLsizei storageHeight() const { return m_storageHeight; }
         GLsizei samples() const { return m_samples; }
         GLenum internalFormat() const { return m_internalFormat; }
 
@@ -111,6 +128,8 @@ namespace gl {
         GLuint m_id = 0;
         GLsizei m_width = 0;
         GLsizei m_height = 0;
+        GLsizei m_storageWidth = 0;
+        GLsizei m_storageHeight = 0;
         GLsizei m_samples = 0;
         GLenum m_internalFormat = 0;
     };
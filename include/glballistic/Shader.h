@@ -1,13 +1,120 @@
 #pragma once
 #include <glad/glad.h>
 #include <glballistic/State.h>
+#include <glballistic/Profiler.h>
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <iostream>
 
 namespace gl {
 
+    // FNV-1a of a uniform or block name. A trailing "[0]" is ignored, so "lights" and
+    // "lights[0]" name the same array, matching what the driver reports for it.
+    constexpr uint64_t HashName(std::string_view name) {
+        if (name.size() > 3 && name.ends_with("[0]")) name.remove_suffix(3);
+        uint64_t h = 14695981039346656037ull;
+        for (char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Name hashed at compile time: setUniform(UniformName("color"), ...) never touches the string.
+    struct UniformName {
+        uint64_t hash;
+        const char* name;
+
+        consteval UniformName(const char* str) : hash(HashName(str)), name(str) {}
+    };
+
+    struct UniformHandle {
+        GLint location{-1};
+
+        explicit operator bool() const { return location >= 0; }
+        bool operator==(const UniformHandle&) const = default;
+    };
+
+    template<typename T>
+    concept GlmVector = requires {
+        typename T::value_type;
+        { T::length() } -> std::convertible_to<int>;
+    } && sizeof(T) == sizeof(typename T::value_type) * T::length();
+
+    template<typename T>
+    concept GlmMatrix = requires {
+        typename T::value_type;
+        typename T::col_type;
+        { T::length() } -> std::convertible_to<int>;
+    } && GlmVector<typename T::col_type> && sizeof(T) == sizeof(typename T::col_type) * T::length();
+
+    template<typename T>
+    concept UniformScalar = std::same_as<T, GLint> || std::same_as<T, GLuint> || std::same_as<T, GLfloat>;
+
+    // Shape of a value setUniform() accepts: scalars, vectors as T[N] or glm vectors, and
+    // float matrices as float[columns][rows] or glm matrices (column-major).
+    template<typename T>
+    struct UniformTraits;
+
+    template<UniformScalar T>
+    struct UniformTraits<T> {
+        using Scalar = T;
+        static constexpr int Columns = 1, Rows = 1;
+    };
+
+    template<UniformScalar T, size_t N> requires (N >= 2 && N <= 4)
+    struct UniformTraits<T[N]> {
+        using Scalar = T;
+        static constexpr int Columns = 1, Rows = static_cast<int>(N);
+    };
+
+    template<size_t C, size_t R> requires (C >= 2 && C <= 4 && R >= 2 && R <= 4)
+    struct UniformTraits<GLfloat[C][R]> {
+        using Scalar = GLfloat;
+        static constexpr int Columns = static_cast<int>(C), Rows = static_cast<int>(R);
+    };
+
+    template<GlmVector T> requires UniformScalar<typename T::value_type> && (T::length() >= 1 && T::length() <= 4)
+    struct UniformTraits<T> {
+        using Scalar = typename T::value_type;
+        static constexpr int Columns = 1, Rows = T::length();
+    };
+
+    template<GlmMatrix T> requires std::same_as<typename T::value_type, GLfloat> && (T::length() >= 2 && T::length() <= 4)
+                                   && (T::col_type::length() >= 2 && T::col_type::length() <= 4)
+    struct UniformTraits<T> {
+        using Scalar = GLfloat;
+        static constexpr int Columns = T::length(), Rows = T::col_type::length();
+    };
+
+    template<typename T>
+    concept UniformValue = requires { typename UniformTraits<T>::Scalar; };
+
+    struct ShaderUniform {
+        std::string name;
+        uint64_t hash{0};
+        GLint location{-1};
+        GLenum type{0};
+        GLint arraySize{1};
+        GLint block{-1};
+        GLint offset{-1};
+    };
+
+    struct ShaderBlock {
+        std::string name;
+        uint64_t hash{0};
+        GLuint index{0};
+        GLint binding{0};
+        GLint size{0};
+    };
+
     class Shader {
     public:
         Shader() = default;
@@ -21,7 +128,17 @@ namespace gl {
             if (this != &other) {
                 destroy();
                 m_id = other.m_id;
+                m_attachedShaders = std::move(other.m_attachedShaders);
+                m_async = other.m_async;
+                m_pending = other.m_pending;
+                m_uniforms = std::move(other.m_uniforms);
+                m_uniformBlocks = std::move(other.m_uniformBlocks);
+                m_storageBlocks = std::move(other.m_storageBlocks);
+                m_extraLocations = std::move(other.m_extraLocations);
+                m_shadow = std::move(other.m_shadow);
                 other.m_id = 0;
+                other.m_pending = false;
+                other.clearReflection();
             }
             return *this;
         }
@@ -33,10 +150,13 @@ namespace gl {
 
         void destroy() {
             if (!m_id) return;
+            for (auto shader : m_attachedShaders)
+                glDeleteShader(shader);
             glDeleteProgram(m_id);
             m_id = 0;
             m_attachedShaders.clear();
-            m_uniformCache.clear();
+            m_pending = false;
+            clearReflection();
         }
 
         bool valid() const { return m_id != 0 && glIsProgram(m_id); }
@@ -49,16 +169,7 @@ namespace gl {
             GLuint shader = glCreateShader(type);
             glShaderSource(shader, 1, &source, nullptr);
             glCompileShader(shader);
-
-            GLint success;
-            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-            if (!success) {
-                GLint length;
-                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-                std::vector<char> infoLog(length);
-                glGetShaderInfoLog(shader, length, nullptr, infoLog.data());
-                std::cerr << "Shader compile error: " << infoLog.data() << std::endl;
-            }
+            if (!m_async) checkCompile(shader);
 
             glAttachShader(m_id, shader);
             m_attachedShaders.push_back(shader);
@@ -71,23 +182,79 @@ namespace gl {
             if (it != m_attachedShaders.end()) m_attachedShaders.erase(it);
         }
 
-        void link() {
+        bool link() {
             glLinkProgram(m_id);
+            clearReflection();
 
-            GLint success;
-            glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-            if (!success) {
-                GLint length;
-                glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &length);
-                std::vector<char> infoLog(length);
-                glGetProgramInfoLog(m_id, length, nullptr, infoLog.data());
-                std::cerr << "Program link error: " << infoLog.data() << std::endl;
+            if (m_async) {
+                m_pending = true;
+                return true;
             }
+            return finishLink();
+        }
 
-            for (auto shader : m_attachedShaders)
-                glDeleteShader(shader);
+        // In async mode attachShader() and link() only submit work; compile and link status
+        // are not queried until wait(), so the driver can build many programs in parallel.
+        // Call wait() (or poll ready() until it returns true) before using the program.
+        void setAsync(bool async) { m_async = async; }
+        bool async() const { return m_async; }
+        bool pending() const { return m_pending; }
 
-            m_attachedShaders.clear();
+        // Never blocks. Without KHR_parallel_shader_compile there is no way to ask, so a
+        // pending program reports ready and wait() does the (blocking) status check.
+        bool ready() const {
+            if (!m_pending) return true;
+            if (!GLAD_GL_KHR_parallel_shader_compile) return true;
+
+            GLint done = GL_FALSE;
+            glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &done);
+            return done == GL_TRUE;
+        }
+
+        bool wait() {
+            if (m_pending) return finishLink();
+            return linked();
+        }
+
+        // Lets the driver use as many compiler threads as it likes (0xFFFFFFFF) or a fixed
+        // number. Returns false when KHR_parallel_shader_compile is unavailable.
+        static bool setCompilerThreads(GLuint count = 0xFFFFFFFFu) {
+            if (!GLAD_GL_KHR_parallel_shader_compile) return false;
+            glMaxShaderCompilerThreadsKHR(count);
+            return true;
+        }
+
+        bool linked() const {
+            GLint status = GL_FALSE;
+            glGetProgramiv(m_id, GL_LINK_STATUS, &status);
+            return status == GL_TRUE;
+        }
+
+        // Must be called before link() for getBinary() to return anything.
+        void setBinaryRetrievable(bool retrievable = true) {
+            glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, retrievable ? GL_TRUE : GL_FALSE);
+        }
+
+        // Fails (and leaves the program unlinked) when the driver rejects the binary, e.g.
+        // after a driver update; the caller then has to compile from source.
+        bool loadBinary(GLenum format, const void* data, GLsizei size) {
+            glProgramBinary(m_id, format, data, size);
+            clearReflection();
+            if (!linked()) return false;
+            reflect();
+            return true;
+        }
+
+        bool getBinary(GLenum& format, std::vector<unsigned char>& data) const {
+            GLint length = 0;
+            glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0) return false;
+
+            data.resize(static_cast<size_t>(length));
+            GLsizei written = 0;
+            glGetProgramBinary(m_id, length, &written, &format, data.data());
+            data.resize(static_cast<size_t>(written));
+            return written > 0;
         }
 
         void validate() const {
@@ -103,21 +270,58 @@ namespace gl {
             }
         }
 
-        template<typename T>
-        void setUniform(const char* name, const T& value) const;
+        // Resolve once after link() and keep the handle; setting through it skips every lookup.
+        UniformHandle uniform(std::string_view name) const { return {location(HashName(name), name)}; }
+
+        // Values are compared against a per-program shadow copy and only uploaded when they
+        // differ. With glProgramUniform* the program does not need to be bound; otherwise it
+        // is bound through State first. Writing uniforms with raw glUniform* calls bypasses
+        // the shadow, so call invalidateUniforms() after doing that.
+        template<UniformValue T>
+        void setUniform(UniformHandle handle, std::span<const T> values) const {
+            if (!handle || values.empty()) return;
+
+            bool issue = updateShadow(handle.location, values);
+            GLBALLISTIC_STAT(State::countUniform(issue));
+            if (!issue) return;
+
+            upload(handle.location, static_cast<GLsizei>(values.size()), values.data());
+        }
 
-        template<> void setUniform<int>(const char* name, const int& value) const { glUniform1i(getUniformLocation(name), value); }
-        template<> void setUniform<float>(const char* name, const float& value) const { glUniform1f(getUniformLocation(name), value); }
-        template<> void setUniform<float[2]>(const char* name, const float (&value)[2]) const { glUniform2fv(getUniformLocation(name), 1, value); }
-        template<> void setUniform<float[3]>(const char* name, const float (&value)[3]) const { glUniform3fv(getUniformLocation(name), 1, value); }
-        template<> void setUniform<float[4]>(const char* name, const float (&value)[4]) const { glUniform4fv(getUniformLocation(name), 1, value); }
-        template<> void setUniform<float[3][3]>(const char* name, const float (&value)[3][3]) const { glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &value[0][0]); }
-        template<> void setUniform<float[4][4]>(const char* name, const float (&value)[4][4]) const { glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &value[0][0]); }
+        template<UniformValue T>
+        void setUniform(UniformHandle handle, const T& value) const { setUniform(handle, std::span<const T>(&value, 1)); }
+
+        template<UniformValue T>
+        void setUniform(const char* name, const T& value) const { setUniform(UniformHandle{getUniformLocation(name)}, value); }
+
+        template<UniformValue T>
+        void setUniform(const char* name, std::span<const T> values) const { setUniform(UniformHandle{getUniformLocation(name)}, values); }
+
+        template<UniformValue T>
+        void setUniform(UniformName name, const T& value) const { setUniform(UniformHandle{location(name.hash, name.name)}, value); }
+
+        template<UniformValue T>
+        void setUniform(UniformName name, std::span<const T> values) const { setUniform(UniformHandle{location(name.hash, name.name)}, values); }
+
+        void invalidateUniforms() const { m_shadow.clear(); }
+
+        // Reflected at link time, sorted by name hash.
+        const std::vector<ShaderUniform>& uniforms() const { return m_uniforms; }
+        const std::vector<ShaderBlock>& uniformBlocks() const { return m_uniformBlocks; }
+        const std::vector<ShaderBlock>& storageBlocks() const { return m_storageBlocks; }
+
+        const ShaderUniform* findUniform(std::string_view name) const { return find(m_uniforms, HashName(name)); }
+        const ShaderBlock* findUniformBlock(std::string_view name) const { return find(m_uniformBlocks, HashName(name)); }
+        const ShaderBlock* findStorageBlock(std::string_view name) const { return find(m_storageBlocks, HashName(name)); }
 
         void dispatchCompute(GLuint x, GLuint y, GLuint z, GLbitfield barriers = 0) const {
+            GLBALLISTIC_PROFILE_ZONE("Shader::dispatchCompute");
             use();
+            State::flush();
+            State::syncDispatch();
+            GLBALLISTIC_STAT(State::countDispatch());
             glDispatchCompute(x, y, z);
-            if (barriers) glMemoryBarrier(barriers);
+            State::memoryBarrier(barriers);
         }
 
         void getActiveUniforms(std::vector<std::string>& outNames) const {
@@ -146,15 +350,274 @@ namespace gl {
     private:
         GLuint m_id{0};
         std::vector<GLuint> m_attachedShaders;
-        mutable std::unordered_map<std::string, GLint> m_uniformCache;
+        bool m_async{false};
+        bool m_pending{false};
+        std::vector<ShaderUniform> m_uniforms;
+        std::vector<ShaderBlock> m_uniformBlocks;
+        std::vector<ShaderBlock> m_storageBlocks;
+        mutable std::unordered_map<uint64_t, GLint> m_extraLocations;
+
+        // Last value uploaded per location; array elements occupy consecutive locations.
+        struct ShadowValue {
+            GLuint size{0};
+            alignas(16) unsigned char data[64];
+        };
+        mutable std::vector<ShadowValue> m_shadow;
+
+        static void checkCompile(GLuint shader) {
+            GLint success;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                GLint length;
+                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+                std::vector<char> infoLog(length);
+                glGetShaderInfoLog(shader, length, nullptr, infoLog.data());
+                std::cerr << "Shader compile error: " << infoLog.data() << std::endl;
+            }
+        }
+
+        bool finishLink() {
+            if (m_pending) {
+                for (auto shader : m_attachedShaders)
+                    checkCompile(shader);
+                m_pending = false;
+            }
+
+            GLint success;
+            glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+            if (!success) {
+                GLint length;
+                glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &length);
+                std::vector<char> infoLog(length);
+                glGetProgramInfoLog(m_id, length, nullptr, infoLog.data());
+                std::cerr << "Program link error: " << infoLog.data() << std::endl;
+            }
+
+            for (auto shader : m_attachedShaders)
+                glDeleteShader(shader);
+
+            m_attachedShaders.clear();
+            if (success) reflect();
+            return success;
+        }
+
+        GLint getUniformLocation(const char* name) const {
+            return location(HashName(name), name);
+        }
+
+        // Names the reflection table does not cover (array elements past [0], struct fields of
+        // array elements) are asked of the driver once and remembered by hash.
+        GLint location(uint64_t hash, std::string_view name) const {
+            if (const ShaderUniform* uniform = find(m_uniforms, hash)) return uniform->location;
 
-        GLuint getUniformLocation(const char* name) const {
-            auto it = m_uniformCache.find(name);
-            if (it != m_uniformCache.end()) return it->second;
-            GLint loc = glGetUniformLocation(m_id, name);
-            m_uniformCache[name] = loc;
+            auto it = m_extraLocations.find(hash);
+            if (it != m_extraLocations.end()) return it->second;
+            GLint loc = glGetUniformLocation(m_id, std::string(name).c_str());
+            m_extraLocations[hash] = loc;
             return loc;
         }
+
+        template<typename T>
+        static const T* find(const std::vector<T>& table, uint64_t hash) {
+            auto it = std::lower_bound(table.begin(), table.end(), hash, [](const T& entry, uint64_t h) { return entry.hash < h; });
+            return it != table.end() && it->hash == hash ? &*it : nullptr;
+        }
+
+        void clearReflection() {
+            m_uniforms.clear();
+            m_uniformBlocks.clear();
+            m_storageBlocks.clear();
+            m_extraLocations.clear();
+            m_shadow.clear();
+        }
+
+        static void normalize(std::string& name) {
+            if (name.size() > 3 && name.ends_with("[0]")) name.resize(name.size() - 3);
+        }
+
+        void reflect() {
+            clearReflection();
+
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_program_interface_query) {
+                reflectUniforms();
+                reflectBlocks(GL_UNIFORM_BLOCK, m_uniformBlocks);
+                reflectBlocks(GL_SHADER_STORAGE_BLOCK, m_storageBlocks);
+            } else {
+                reflectUniformsLegacy();
+            }
+
+            auto byHash = [](const auto& a, const auto& b) { return a.hash < b.hash; };
+            std::sort(m_uniforms.begin(), m_uniforms.end(), byHash);
+            std::sort(m_uniformBlocks.begin(), m_uniformBlocks.end(), byHash);
+            std::sort(m_storageBlocks.begin(), m_storageBlocks.end(), byHash);
+        }
+
+        void reflectUniforms() {
+            GLint count = 0, maxLength = 0;
+            glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+            glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxLength);
+            std::vector<char> nameData(static_cast<size_t>(std::max(maxLength, 1)));
+
+            const GLenum props[] = {GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET};
+            GLint values[5];
+            m_uniforms.reserve(static_cast<size_t>(count));
+
+            for (GLint i = 0; i < count; i++) {
+                glGetProgramResourceiv(m_id, GL_UNIFORM, i, 5, props, 5, nullptr, values);
+                GLsizei length = 0;
+                glGetProgramResourceName(m_id, GL_UNIFORM, i, maxLength, &length, nameData.data());
+
+                ShaderUniform uniform;
+                uniform.name.assign(nameData.data(), length);
+                normalize(uniform.name);
+                uniform.hash = HashName(uniform.name);
+                uniform.type = static_cast<GLenum>(values[0]);
+                uniform.arraySize = values[1];
+                uniform.location = values[2];
+                uniform.block = values[3];
+                uniform.offset = values[4];
+                m_uniforms.push_back(std::move(uniform));
+            }
+        }
+
+        void reflectBlocks(GLenum interface, std::vector<ShaderBlock>& out) {
+            GLint count = 0, maxLength = 0;
+            glGetProgramInterfaceiv(m_id, interface, GL_ACTIVE_RESOURCES, &count);
+            glGetProgramInterfaceiv(m_id, interface, GL_MAX_NAME_LENGTH, &maxLength);
+            std::vector<char> nameData(static_cast<size_t>(std::max(maxLength, 1)));
+
+            const GLenum props[] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+            GLint values[2];
+            out.reserve(static_cast<size_t>(count));
+
+            for (GLint i = 0; i < count; i++) {
+                glGetProgramResourceiv(m_id, interface, i, 2, props, 2, nullptr, values);
+                GLsizei length = 0;
+                glGetProgramResourceName(m_id, interface, i, maxLength, &length, nameData.data());
+
+                ShaderBlock block;
+                block.name.assign(nameData.data(), length);
+                normalize(block.name);
+                block.hash = HashName(block.name);
+                block.index = static_cast<GLuint>(i);
+                block.binding = values[0];
+                block.size = values[1];
+                out.push_back(std::move(block));
+            }
+        }
+
+        void reflectUniformsLegacy() {
+            GLint count = 0, maxLength = 0;
+            glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+            std::vector<char> nameData(static_cast<size_t>(std::max(maxLength, 1)));
+            m_uniforms.reserve(static_cast<size_t>(count));
+
+            for (GLint i = 0; i < count; i++) {
+                GLuint index = static_cast<GLuint>(i);
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(m_id, index, maxLength, &length, &size, &type, nameData.data());
+
+                ShaderUniform uniform;
+                uniform.name.assign(nameData.data(), length);
+                uniform.location = glGetUniformLocation(m_id, uniform.name.c_str());
+                normalize(uniform.name);
+                uniform.hash = HashName(uniform.name);
+                uniform.type = type;
+                uniform.arraySize = size;
+                glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_BLOCK_INDEX, &uniform.block);
+                glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_OFFSET, &uniform.offset);
+                m_uniforms.push_back(std::move(uniform));
+            }
+
+            GLint blocks = 0;
+            glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &blocks);
+            for (GLint i = 0; i < blocks; i++) {
+                GLuint index = static_cast<GLuint>(i);
+                GLint nameLength = 0;
+                glGetActiveUniformBlockiv(m_id, index, GL_UNIFORM_BLOCK_NAME_LENGTH, &nameLength);
+                std::vector<char> blockName(static_cast<size_t>(std::max(nameLength, 1)));
+                GLsizei length = 0;
+                glGetActiveUniformBlockName(m_id, index, nameLength, &length, blockName.data());
+
+                ShaderBlock block;
+                block.name.assign(blockName.data(), length);
+                normalize(block.name);
+                block.hash = HashName(block.name);
+                block.index = index;
+                glGetActiveUniformBlockiv(m_id, index, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+                glGetActiveUniformBlockiv(m_id, index, GL_UNIFORM_BLOCK_DATA_SIZE, &block.size);
+                m_uniformBlocks.push_back(std::move(block));
+            }
+        }
+
+        template<typename T>
+        bool updateShadow(GLint location, std::span<const T> values) const {
+            static_assert(sizeof(T) <= sizeof(ShadowValue::data));
+
+            size_t end = static_cast<size_t>(location) + values.size();
+            if (m_shadow.size() < end) m_shadow.resize(end);
+
+            bool changed = false;
+            for (size_t i = 0; i < values.size(); i++) {
+                ShadowValue& shadow = m_shadow[static_cast<size_t>(location) + i];
+                if (shadow.size != sizeof(T) || std::memcmp(shadow.data, &values[i], sizeof(T)) != 0) {
+                    shadow.size = sizeof(T);
+                    std::memcpy(shadow.data, &values[i], sizeof(T));
+                    changed = true;
+                }
+            }
+            return changed;
+        }
+
+        template<typename T>
+        void upload(GLint location, GLsizei count, const T* values) const {
+            using Traits = UniformTraits<T>;
+            using Scalar = typename Traits::Scalar;
+            constexpr int C = Traits::Columns, R = Traits::Rows;
+            const Scalar* data = reinterpret_cast<const Scalar*>(values);
+
+            if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_separate_shader_objects) {
+                if constexpr (C > 1) {
+                    const PFNGLPROGRAMUNIFORMMATRIX2FVPROC matrix[3][3] = {
+                        {glProgramUniformMatrix2fv, glProgramUniformMatrix2x3fv, glProgramUniformMatrix2x4fv},
+                        {glProgramUniformMatrix3x2fv, glProgramUniformMatrix3fv, glProgramUniformMatrix3x4fv},
+                        {glProgramUniformMatrix4x2fv, glProgramUniformMatrix4x3fv, glProgramUniformMatrix4fv}};
+                    matrix[C - 2][R - 2](m_id, location, count, GL_FALSE, data);
+                } else if constexpr (std::same_as<Scalar, GLfloat>) {
+                    const PFNGLPROGRAMUNIFORM1FVPROC vector[4] = {glProgramUniform1fv, glProgramUniform2fv, glProgramUniform3fv, glProgramUniform4fv};
+                    vector[R - 1](m_id, location, count, data);
+                } else if constexpr (std::same_as<Scalar, GLint>) {
+                    const PFNGLPROGRAMUNIFORM1IVPROC vector[4] = {glProgramUniform1iv, glProgramUniform2iv, glProgramUniform3iv, glProgramUniform4iv};
+                    vector[R - 1](m_id, location, count, data);
+                } else {
+                    const PFNGLPROGRAMUNIFORM1UIVPROC vector[4] = {glProgramUniform1uiv, glProgramUniform2uiv, glProgramUniform3uiv, glProgramUniform4uiv};
+                    vector[R - 1](m_id, location, count, data);
+                }
+                return;
+            }
+
+            use();
+            State::commitShader();
+            if constexpr (C > 1) {
+                const PFNGLUNIFORMMATRIX2FVPROC matrix[3][3] = {
+                    {glUniformMatrix2fv, glUniformMatrix2x3fv, glUniformMatrix2x4fv},
+                    {glUniformMatrix3x2fv, glUniformMatrix3fv, glUniformMatrix3x4fv},
+                    {glUniformMatrix4x2fv, glUniformMatrix4x3fv, glUniformMatrix4fv}};
+                matrix[C - 2][R - 2](location, count, GL_FALSE, data);
+            } else if constexpr (std::same_as<Scalar, GLfloat>) {
+                const PFNGLUNIFORM1FVPROC vector[4] = {glUniform1fv, glUniform2fv, glUniform3fv, glUniform4fv};
+                vector[R - 1](location, count, data);
+            } else if constexpr (std::same_as<Scalar, GLint>) {
+                const PFNGLUNIFORM1IVPROC vector[4] = {glUniform1iv, glUniform2iv, glUniform3iv, glUniform4iv};
+                vector[R - 1](location, count, data);
+            } else {
+                const PFNGLUNIFORM1UIVPROC vector[4] = {glUniform1uiv, glUniform2uiv, glUniform3uiv, glUniform4uiv};
+                vector[R - 1](location, count, data);
+            }
+        }
     };
 
 }
\ No newline at end of file
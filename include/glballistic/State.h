@@ -1,141 +1,1276 @@
 #pragma once
 #include <glad/glad.h>
+#include <glballistic/RenderState.h>
+#include <glballistic/Names.h>
+#include <glballistic/Hazards.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+#ifdef GLBALLISTIC_STATS
+#define GLBALLISTIC_STAT(expr) expr
+#else
+#define GLBALLISTIC_STAT(expr) ((void)0)
+#endif
 
 namespace gl {
 
+    struct StateCounter {
+        uint64_t issued{0};
+        uint64_t elided{0};
+
+        void record(bool issue) { issue ? issued++ : elided++; }
+        uint64_t calls() const { return issued + elided; }
+        double elisionRate() const { return calls() ? static_cast<double>(elided) / static_cast<double>(calls()) : 0.0; }
+    };
+
+    // Per-frame counters of calls that reached the driver (issued) versus calls the cache
+    // absorbed (elided). Only populated when built with GLBALLISTIC_STATS.
+    struct StateStats {
+        uint64_t frame{0};
+
+        StateCounter buffer;
+        StateCounter bufferBase;
+        StateCounter bufferRange;
+        StateCounter texture;
+        StateCounter activeTexture;
+        StateCounter image;
+        StateCounter program;
+        StateCounter vertexArray;
+        StateCounter framebuffer;
+        StateCounter renderbuffer;
+        StateCounter renderState;
+        StateCounter multiBind;
+        StateCounter uniform;
+
+        uint64_t deferred{0};
+        uint64_t uploads{0};
+        uint64_t uploadBytes{0};
+        uint64_t draws{0};
+        uint64_t dispatches{0};
+        uint64_t copies{0};
+        uint64_t copyBytes{0};
+        uint64_t clears{0};
+        uint64_t maps{0};
+        uint64_t barriers{0};
+    };
+
     struct pair_hash {
         size_t operator()(const std::pair<GLenum, GLuint>& p) const noexcept {
             return std::hash<GLenum>{}(p.first) ^ (std::hash<GLuint>{}(p.second) << 1);
         }
     };
 
-    class State {
+    struct BufferRange {
+        GLuint id{0};
+        GLintptr offset{0};
+        GLsizeiptr size{0};
+
+        bool operator==(const BufferRange&) const = default;
+    };
+
+    struct ImageBinding {
+        GLuint id{0};
+        GLint level{0};
+        GLboolean layered{GL_FALSE};
+        GLint layer{0};
+        GLenum access{GL_READ_ONLY};
+        GLenum format{GL_R8};
+        GLenum textureFormat{GL_NONE};
+
+        bool operator==(const ImageBinding&) const = default;
+    };
+
+    struct DirtyRange {
+        GLuint begin{~0u}, end{0};
+
+        void add(GLuint index) {
+            begin = std::min(begin, index);
+            end = std::max(end, index + 1);
+        }
+
+        bool empty() const { return begin >= end; }
+        void clear() { begin = ~0u; end = 0; }
+    };
+
+    // Binding and render-state cache for one GL context. Contexts that share objects still
+    // have separate binding state, so each one needs its own Context.
+    class Context {
     public:
-        static void bindBuffer(GLenum target, GLuint id) {
-            if (boundBuffers[target] != id) {
+        Context() = default;
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+        static constexpr GLuint InvalidSlot = ~0u;
+        static constexpr size_t BufferTargetCount = 15;
+        static constexpr size_t IndexedTargetCount = 4;
+        static constexpr size_t TextureTargetCount = 11;
+        static constexpr GLuint DefaultSlotCount = 32;
+
+        // Sizes the dense slot tables from the driver limits. Needs a current context;
+        // without it the tables keep DefaultSlotCount entries and anything beyond that
+        // goes through the fallback maps.
+        void init() {
+            GLint units = 0, images = 0;
+            glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
+            glGetIntegerv(GL_MAX_IMAGE_UNITS, &images);
+
+            GLint bases[IndexedTargetCount] = {};
+            glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &bases[0]);
+            glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &bases[1]);
+            glGetIntegerv(GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS, &bases[2]);
+            glGetIntegerv(GL_MAX_TRANSFORM_FEEDBACK_BUFFERS, &bases[3]);
+
+            textureUnitCount = units > 0 ? static_cast<GLuint>(units) : DefaultSlotCount;
+            boundTextureUnits.assign(textureUnitCount, 0);
+            boundTextures.assign(textureUnitCount * TextureTargetCount, 0);
+            boundImages.assign(images > 0 ? static_cast<size_t>(images) : DefaultSlotCount, ImageBinding{});
+
+            for (size_t i = 0; i < IndexedTargetCount; i++)
+                boundBases[i].assign(bases[i] > 0 ? static_cast<size_t>(bases[i]) : DefaultSlotCount, BufferRange{});
+
+            reset();
+        }
+
+        // Deferred mode records program, vertex array, texture unit, image unit and indexed
+        // buffer bindings and commits only the net difference in flush(), which the draw and
+        // dispatch calls run. Editing paths without DSA bind objects to modify them, so the
+        // mode is only entered when DSA is available; returns whether it is active.
+        bool setDeferred(bool enabled) {
+            if (!enabled) {
+                flush();
+                deferredMode = false;
+                return false;
+            }
+
+            if (!(GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access))
+                return false;
+
+            if (!deferredMode) {
+                syncDesired();
+                deferredMode = true;
+            }
+            return true;
+        }
+
+        bool deferred() const { return deferredMode; }
+
+        void flush() {
+            if (!deferredMode) return;
+
+            commitShader();
+            bool issue = boundVertexArray != desiredVertexArray;
+            GLBALLISTIC_STAT(stats.vertexArray.record(issue));
+            if (issue) {
+                glBindVertexArray(desiredVertexArray);
+                boundVertexArray = desiredVertexArray;
+            }
+
+            flushTextures();
+            flushImages();
+            for (size_t slot = 0; slot < IndexedTargetCount; slot++)
+                flushBases(slot);
+        }
+
+        void commitShader() {
+            if (!deferredMode) return;
+            bool issue = boundShader != desiredShader;
+            GLBALLISTIC_STAT(stats.program.record(issue));
+            if (issue) {
+                glUseProgram(desiredShader);
+                boundShader = desiredShader;
+            }
+        }
+
+        void bindBuffer(GLenum target, GLuint id) {
+            GLuint& bound = bufferBinding(target);
+            bool issue = bound != id;
+            GLBALLISTIC_STAT(stats.buffer.record(issue));
+            if (issue) {
                 glBindBuffer(target, id);
-                boundBuffers[target] = id;
+                bound = id;
             }
         }
 
-        static void bindBufferBase(GLenum target, GLuint index, GLuint id) {
-            auto key = std::make_pair(target, index);
-            if (boundBases[key] != id) {
-                glBindBufferBase(target, index, id);
-                boundBases[key] = id;
+        // A size of 0 records a whole-buffer (base) binding. Both calls also replace the
+        // generic binding point of the target, so that cache is updated as well. access only
+        // informs hazard tracking: storage buffers bound GL_READ_ONLY are not counted as written.
+        void bindBufferBase(GLenum target, GLuint index, GLuint id, GLenum access = GL_READ_WRITE) {
+            if (hazardTracker.enabled()) hazardTracker.bindStorage(target, index, id, access);
+            if (deferredMode && deferBase(target, index, BufferRange{id, 0, 0})) return;
+            commitBufferBase(target, index, id);
+        }
+
+        void bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr size, GLenum access = GL_READ_WRITE) {
+            if (hazardTracker.enabled()) hazardTracker.bindStorage(target, index, id, access);
+            if (deferredMode && deferBase(target, index, BufferRange{id, offset, size})) return;
+            commitBufferRange(target, index, BufferRange{id, offset, size});
+        }
+
+        // Batch binds over [first, first + ids.size()). Only the sub-span that differs from the
+        // cache is committed, in a single glBindBuffersBase call when ARB_multi_bind is available.
+        // access applies to every buffer in the batch, as for bindBufferBase().
+        void bindBuffersBase(GLenum target, GLuint first, std::span<const GLuint> ids, GLenum access = GL_READ_WRITE) {
+            if (deferredMode && indexedSlot(target) != InvalidSlot) {
+                for (size_t i = 0; i < ids.size(); i++)
+                    bindBufferBase(target, first + static_cast<GLuint>(i), ids[i], access);
+                return;
             }
+            if (hazardTracker.enabled()) {
+                for (size_t i = 0; i < ids.size(); i++)
+                    hazardTracker.bindStorage(target, first + static_cast<GLuint>(i), ids[i], access);
+            }
+            commitBuffersBase(target, first, ids);
         }
 
-        static void bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr size) {
-            auto key = std::make_pair(target, index);
-            if (boundBases[key] != id) {
-                glBindBufferRange(target, index, id, offset, size);
-                boundBases[key] = id;
+        void bindBuffersRange(GLenum target, GLuint first, std::span<const BufferRange> ranges, GLenum access = GL_READ_WRITE) {
+            if (deferredMode && indexedSlot(target) != InvalidSlot) {
+                for (size_t i = 0; i < ranges.size(); i++)
+                    bindBufferRange(target, first + static_cast<GLuint>(i), ranges[i].id, ranges[i].offset, ranges[i].size, access);
+                return;
+            }
+            if (hazardTracker.enabled()) {
+                for (size_t i = 0; i < ranges.size(); i++)
+                    hazardTracker.bindStorage(target, first + static_cast<GLuint>(i), ranges[i].id, access);
             }
+            commitBuffersRange(target, first, ranges);
         }
-        
-        static void bindVertexArray(GLuint id) {
-            if (boundVertexArray != id) {
+
+        void bindVertexArray(GLuint id) {
+            if (deferredMode) {
+                desiredVertexArray = id;
+                GLBALLISTIC_STAT(stats.deferred++);
+                return;
+            }
+            bool issue = boundVertexArray != id;
+            GLBALLISTIC_STAT(stats.vertexArray.record(issue));
+            if (issue) {
                 glBindVertexArray(id);
                 boundVertexArray = id;
             }
         }
 
-        static void bindShader(GLuint id) {
-            if (boundShader != id) {
+        void bindShader(GLuint id) {
+            if (deferredMode) {
+                desiredShader = id;
+                GLBALLISTIC_STAT(stats.deferred++);
+                return;
+            }
+            bool issue = boundShader != id;
+            GLBALLISTIC_STAT(stats.program.record(issue));
+            if (issue) {
                 glUseProgram(id);
                 boundShader = id;
             }
         }
 
-        static void bindTexture(GLuint unit, GLenum target, GLuint id) {
-            activeTexture(unit);
+        void bindTexture(GLuint unit, GLenum target, GLuint id) {
+            if (deferredMode && unit < desiredTextures.size()) {
+                desiredTextures[unit] = id;
+                dirtyTextures.add(unit);
+                GLBALLISTIC_STAT(stats.deferred++);
+                return;
+            }
 
             if (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access) {
-                if (boundTextureUnits[unit] != id) {
+                GLuint& bound = textureUnitBinding(unit);
+                bool issue = bound != id;
+                GLBALLISTIC_STAT(stats.texture.record(issue));
+                if (issue) {
                     glBindTextureUnit(unit, id);
-                    boundTextureUnits[unit] = id;
+                    bound = id;
                 }
             } else {
-                auto key = std::make_pair(target, unit);
-                if (boundTextures[key] != id) {
+                GLuint& bound = textureBinding(unit, target);
+                bool issue = bound != id;
+                GLBALLISTIC_STAT(stats.texture.record(issue));
+                if (issue) {
+                    activeTexture(unit);
                     glBindTexture(target, id);
-                    boundTextures[key] = id;
+                    bound = id;
                 }
             }
         }
 
-        static void activeTexture(GLuint unit) {
+        // What bindTexture() last put on unit for target, including deferred binds, so a wrapper
+        // that has to borrow a unit can put it back.
+        GLuint boundTexture(GLuint unit, GLenum target) {
+            if (deferredMode && unit < desiredTextures.size()) return desiredTextures[unit];
+            if (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_direct_state_access) return textureUnitBinding(unit);
+            return textureBinding(unit, target);
+        }
+
+        // textureFormat is the internal format the texture was created with, if the caller
+        // knows it; only such bindings can be folded into a glBindImageTextures batch.
+        void bindImageTexture(GLuint unit, GLuint id, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format, GLenum textureFormat = GL_NONE) {
+            ImageBinding binding{id, level, layered, layer, access, format, textureFormat};
+            if (hazardTracker.enabled()) hazardTracker.bindImage(unit, id, access);
+            if (deferredMode && unit < desiredImages.size()) {
+                desiredImages[unit] = binding;
+                dirtyImages.add(unit);
+                GLBALLISTIC_STAT(stats.deferred++);
+                return;
+            }
+
+            if (unit >= boundImages.size()) {
+                glBindImageTexture(unit, id, level, layered, layer, access, format);
+                GLBALLISTIC_STAT(stats.image.issued++);
+                return;
+            }
+
+            bool issue = boundImages[unit] != binding;
+            GLBALLISTIC_STAT(stats.image.record(issue));
+            if (issue) {
+                glBindImageTexture(unit, id, level, layered, layer, access, format);
+                boundImages[unit] = binding;
+            }
+        }
+
+        void activeTexture(GLuint unit) {
+            GLBALLISTIC_STAT(stats.activeTexture.record(activeTexUnit != unit));
             if (activeTexUnit != unit) {
                 glActiveTexture(GL_TEXTURE0 + unit);
                 activeTexUnit = unit;
             }
         }
 
-        static void bindRenderbuffer(GLuint id) {
-            if (boundRenderbuffer != id) {
+        void bindRenderbuffer(GLuint id) {
+            bool issue = boundRenderbuffer != id;
+            GLBALLISTIC_STAT(stats.renderbuffer.record(issue));
+            if (issue) {
                 glBindRenderbuffer(GL_RENDERBUFFER, id);
                 boundRenderbuffer = id;
             }
         }
 
-        static void bindFramebuffer(GLuint id, GLenum target = GL_FRAMEBUFFER) {
-            GLuint* slot = nullptr;
-
+        // GL_FRAMEBUFFER sets both the draw and the read binding, so it is tracked as that pair
+        // rather than as a third binding of its own: binding it updates both caches, and it is
+        // only elided when both already match. A later bind of either target alone is then
+        // elided or issued correctly.
+        void bindFramebuffer(GLuint id, GLenum target = GL_FRAMEBUFFER) {
+            bool issue = false;
             switch (target) {
                 case GL_FRAMEBUFFER:
-                    slot = &boundFramebuffer;
+                    issue = boundDrawFramebuffer != id || boundReadFramebuffer != id;
+                    if (issue) boundDrawFramebuffer = boundReadFramebuffer = id;
                     break;
                 case GL_DRAW_FRAMEBUFFER:
-                    slot = &boundDrawFramebuffer;
+                    issue = boundDrawFramebuffer != id;
+                    boundDrawFramebuffer = id;
                     break;
                 case GL_READ_FRAMEBUFFER:
-                    slot = &boundReadFramebuffer;
+                    issue = boundReadFramebuffer != id;
+                    boundReadFramebuffer = id;
                     break;
                 default:
-                    glBindFramebuffer(target, id);
-                    return;
+                    issue = true;
+                    break;
             }
 
-            if (*slot != id) {
+            GLBALLISTIC_STAT(stats.framebuffer.record(issue));
+            if (issue)
                 glBindFramebuffer(target, id);
-                *slot = id;
+        }
+
+        GLuint boundFramebuffer(GLenum target = GL_DRAW_FRAMEBUFFER) const {
+            return target == GL_READ_FRAMEBUFFER ? boundReadFramebuffer : boundDrawFramebuffer;
+        }
+
+        void enable(GLenum cap, bool on = true) {
+            GLuint bit = RenderState::enableBit(cap);
+            if (!bit) {
+                GLBALLISTIC_STAT(stats.renderState.issued++);
+                on ? glEnable(cap) : glDisable(cap);
+                return;
             }
+            setEnables(on ? bit : 0, bit);
         }
 
-        static void reset() {
-            boundBuffers.clear();
-            boundBases.clear();
-            boundTextures.clear();
-            boundTextureUnits.clear();
+        void setEnables(GLuint enables, GLuint mask = AllEnables) {
+            mask &= AllEnables;
+            GLuint changed = ((renderState.enables ^ enables) | ~knownEnables) & mask;
+            GLBALLISTIC_STAT(stats.renderState.record(changed != 0));
+            if (!changed) return;
+
+            for (GLuint bits = changed; bits; bits &= bits - 1) {
+                GLuint bit = bits & (~bits + 1);
+                if (enables & bit)
+                    glEnable(RenderState::capability(bit));
+                else
+                    glDisable(RenderState::capability(bit));
+            }
+
+            renderState.enables = (renderState.enables & ~mask) | (enables & mask);
+            knownEnables |= mask;
+            appliedPipeline = 0;
+        }
+
+        void blendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) {
+            auto& b = renderState.blend;
+            bool issue = b.srcRGB != srcRGB || b.dstRGB != dstRGB || b.srcAlpha != srcAlpha || b.dstAlpha != dstAlpha;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+                b.srcRGB = srcRGB;
+                b.dstRGB = dstRGB;
+                b.srcAlpha = srcAlpha;
+                b.dstAlpha = dstAlpha;
+                appliedPipeline = 0;
+            }
+        }
+
+        void blendEquation(GLenum opRGB, GLenum opAlpha) {
+            auto& b = renderState.blend;
+            bool issue = b.opRGB != opRGB || b.opAlpha != opAlpha;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glBlendEquationSeparate(opRGB, opAlpha);
+                b.opRGB = opRGB;
+                b.opAlpha = opAlpha;
+                appliedPipeline = 0;
+            }
+        }
+
+        void depthFunc(GLenum func) {
+            bool issue = renderState.depth.func != func;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glDepthFunc(func);
+                renderState.depth.func = func;
+                appliedPipeline = 0;
+            }
+        }
+
+        void depthMask(bool write) {
+            GLuint value = write ? GL_TRUE : GL_FALSE;
+            bool issue = renderState.depth.write != value;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glDepthMask(static_cast<GLboolean>(value));
+                renderState.depth.write = value;
+                appliedPipeline = 0;
+            }
+        }
+
+        void stencilFunc(GLenum func, GLint ref, GLuint mask) {
+            auto& s = renderState.stencil;
+            bool issue = s.func != func || s.ref != ref || s.readMask != mask;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glStencilFunc(func, ref, mask);
+                s.func = func;
+                s.ref = ref;
+                s.readMask = mask;
+                appliedPipeline = 0;
+            }
+        }
+
+        void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+            auto& s = renderState.stencil;
+            bool issue = s.sfail != sfail || s.dpfail != dpfail || s.dppass != dppass;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glStencilOp(sfail, dpfail, dppass);
+                s.sfail = sfail;
+                s.dpfail = dpfail;
+                s.dppass = dppass;
+                appliedPipeline = 0;
+            }
+        }
+
+        void stencilMask(GLuint mask) {
+            bool issue = renderState.stencil.writeMask != mask;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glStencilMask(mask);
+                renderState.stencil.writeMask = mask;
+                appliedPipeline = 0;
+            }
+        }
+
+        void cullFace(GLenum face) {
+            bool issue = renderState.raster.cullFace != face;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glCullFace(face);
+                renderState.raster.cullFace = face;
+                appliedPipeline = 0;
+            }
+        }
+
+        void frontFace(GLenum winding) {
+            bool issue = renderState.raster.frontFace != winding;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glFrontFace(winding);
+                renderState.raster.frontFace = winding;
+                appliedPipeline = 0;
+            }
+        }
+
+        void polygonMode(GLenum mode) {
+            bool issue = renderState.raster.polygonMode != mode;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glPolygonMode(GL_FRONT_AND_BACK, mode);
+                renderState.raster.polygonMode = mode;
+                appliedPipeline = 0;
+            }
+        }
+
+        void polygonOffset(GLfloat factor, GLfloat units) {
+            auto& r = renderState.raster;
+            bool issue = r.offsetFactor != factor || r.offsetUnits != units;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glPolygonOffset(factor, units);
+                r.offsetFactor = factor;
+                r.offsetUnits = units;
+                appliedPipeline = 0;
+            }
+        }
+
+        void colorMask(GLuint mask) {
+            mask &= 0xF;
+            bool issue = renderState.raster.colorMask != mask;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glColorMask(mask & 1 ? GL_TRUE : GL_FALSE, mask & 2 ? GL_TRUE : GL_FALSE,
+                            mask & 4 ? GL_TRUE : GL_FALSE, mask & 8 ? GL_TRUE : GL_FALSE);
+                renderState.raster.colorMask = mask;
+                appliedPipeline = 0;
+            }
+        }
+
+        void viewport(const Rect& rect) {
+            bool issue = renderState.viewport != rect;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glViewport(rect.x, rect.y, rect.width, rect.height);
+                renderState.viewport = rect;
+                appliedPipeline = 0;
+            }
+        }
+
+        void scissor(const Rect& rect) {
+            bool issue = renderState.scissor != rect;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glScissor(rect.x, rect.y, rect.width, rect.height);
+                renderState.scissor = rect;
+                appliedPipeline = 0;
+            }
+        }
+
+        void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+            bool issue = clearColorValue[0] != r || clearColorValue[1] != g || clearColorValue[2] != b || clearColorValue[3] != a;
+            GLBALLISTIC_STAT(stats.renderState.record(issue));
+            if (issue) {
+                glClearColor(r, g, b, a);
+                clearColorValue = {r, g, b, a};
+            }
+        }
+
+        // Fields that have no effect while their feature is disabled (blend factors, depth
+        // and stencil tests, cull face, polygon offset, scissor box) are left untouched.
+        void apply(const RenderState& rs) {
+            setEnables(rs.enables);
+
+            if (rs.enables & RenderState::Blend) {
+                blendFunc(rs.blend.srcRGB, rs.blend.dstRGB, rs.blend.srcAlpha, rs.blend.dstAlpha);
+                blendEquation(rs.blend.opRGB, rs.blend.opAlpha);
+            }
+
+            if (rs.enables & RenderState::DepthTest)
+                depthFunc(rs.depth.func);
+            depthMask(rs.depth.write != GL_FALSE);
+
+            if (rs.enables & RenderState::StencilTest) {
+                stencilFunc(rs.stencil.func, rs.stencil.ref, rs.stencil.readMask);
+                stencilOp(rs.stencil.sfail, rs.stencil.dpfail, rs.stencil.dppass);
+            }
+            stencilMask(rs.stencil.writeMask);
+
+            if (rs.enables & RenderState::CullFace)
+                cullFace(rs.raster.cullFace);
+            frontFace(rs.raster.frontFace);
+            polygonMode(rs.raster.polygonMode);
+            if (rs.enables & RenderState::PolygonOffsetFill)
+                polygonOffset(rs.raster.offsetFactor, rs.raster.offsetUnits);
+            colorMask(rs.raster.colorMask);
+
+            if (!rs.viewport.empty())
+                viewport(rs.viewport);
+            if ((rs.enables & RenderState::ScissorTest) && !rs.scissor.empty())
+                scissor(rs.scissor);
+        }
+
+        void apply(const PipelineState& pipeline) {
+            if (appliedPipeline == pipeline.hash()) {
+                GLBALLISTIC_STAT(stats.renderState.elided++);
+                return;
+            }
+            apply(pipeline.desc());
+            appliedPipeline = pipeline.hash();
+        }
+
+        const RenderState& renderStateCache() const { return renderState; }
+
+        void beginFrame() {
+            GLBALLISTIC_STAT(stats = StateStats{});
+            GLBALLISTIC_STAT(stats.frame = ++frameNumber);
+        }
+
+        void endFrame() {
+            GLBALLISTIC_STAT(lastFrame = stats);
+        }
+
+        ObjectNames& names() { return objectNames; }
+
+        // Binds are not recorded while tracking is off, so switching it on rebuilds the writer
+        // tables from the cached bindings.
+        void setHazardMode(HazardMode mode) {
+            bool wasEnabled = hazardTracker.enabled();
+            hazardTracker.setMode(mode);
+            if (!wasEnabled && hazardTracker.enabled())
+                rebuildHazardBindings();
+        }
+
+        HazardTracker& hazards() { return hazardTracker; }
+
+        // Called by the draw and dispatch wrappers after flush(), so the cached bindings are
+        // the ones the command will use. Orders the command after earlier shader writes to
+        // anything it reads, then records the writes it can make itself.
+        void syncDraw(bool indexed, bool indirect = false) {
+            if (!hazardTracker.enabled()) return;
+            if (hazardTracker.hasPending()) {
+                learnContainers();
+                hazardTracker.requireVertexArray(boundVertexArray, indexed);
+                if (indirect) {
+                    hazardTracker.require(HazardResource::Buffer, boundBuffers[bufferSlot(GL_DRAW_INDIRECT_BUFFER)], GL_COMMAND_BARRIER_BIT);
+                    hazardTracker.require(HazardResource::Buffer, boundBuffers[bufferSlot(GL_PARAMETER_BUFFER)], GL_COMMAND_BARRIER_BIT);
+                }
+                requireShaderInputs();
+                hazardTracker.requireFramebuffer(boundDrawFramebuffer);
+                hazardTracker.resolve("draw");
+            }
+            hazardTracker.recordWrites();
+        }
+
+        void syncDispatch() {
+            if (!hazardTracker.enabled()) return;
+            if (hazardTracker.hasPending()) {
+                requireShaderInputs();
+                hazardTracker.resolve("dispatch");
+            }
+            hazardTracker.recordWrites();
+        }
+
+        // For commands that touch one object outside the shader pipeline: buffer updates,
+        // copies, clears and maps (GL_BUFFER_UPDATE_BARRIER_BIT), texture uploads and
+        // readbacks (GL_TEXTURE_UPDATE_BARRIER_BIT).
+        void syncBuffer(GLuint id, const char* consumer, GLbitfield bit = GL_BUFFER_UPDATE_BARRIER_BIT) {
+            if (!hazardTracker.hasPending()) return;
+            hazardTracker.require(HazardResource::Buffer, id, bit);
+            hazardTracker.resolve(consumer);
+        }
+
+        void syncTexture(GLuint id, const char* consumer, GLbitfield bit = GL_TEXTURE_UPDATE_BARRIER_BIT) {
+            if (!hazardTracker.hasPending()) return;
+            hazardTracker.require(HazardResource::Texture, id, bit);
+            hazardTracker.resolve(consumer);
+        }
+
+        // Explicit barriers go through here so the tracker knows which writes they ordered.
+        void memoryBarrier(GLbitfield bits) {
+            if (!bits) return;
+            GLBALLISTIC_STAT(stats.barriers++);
+            glMemoryBarrier(bits);
+            if (hazardTracker.enabled()) hazardTracker.barrier(bits);
+        }
+
+        const StateStats& frameStats() const { return stats; }
+        const StateStats& lastFrameStats() const { return lastFrame; }
+
+        void countUpload(uint64_t bytes) {
+            stats.uploads++;
+            stats.uploadBytes += bytes;
+        }
+
+        void countDraw() { stats.draws++; }
+        void countDispatch() { stats.dispatches++; }
+
+        // Buffer commands that bypass the binding caches but still reach the driver.
+        void countCopy(uint64_t bytes) {
+            stats.copies++;
+            stats.copyBytes += bytes;
+        }
+
+        void countClear() { stats.clears++; }
+        void countMap() { stats.maps++; }
+        void countUniform(bool issued) { stats.uniform.record(issued); }
+
+        void invalidateRenderState() {
+            renderState = RenderState::unknown();
+            knownEnables = 0;
+            clearColorValue.fill(std::numeric_limits<GLfloat>::quiet_NaN());
+            appliedPipeline = 0;
+        }
+
+        // Deleting an object unbinds it everywhere in the current context, and the driver may
+        // hand its name out again, so every cached slot still holding it is cleared. Call
+        // these right before glDeleteTextures / glDeleteBuffers.
+        void forgetTexture(GLuint id) {
+            if (!id) return;
+            hazardTracker.forget(HazardResource::Texture, id);
+            auto clear = [id](GLuint& bound) { if (bound == id) bound = 0; };
+            std::for_each(boundTextureUnits.begin(), boundTextureUnits.end(), clear);
+            std::for_each(boundTextures.begin(), boundTextures.end(), clear);
+            std::for_each(desiredTextures.begin(), desiredTextures.end(), clear);
+            for (auto& [unit, bound] : fallbackTextureUnits) clear(bound);
+            for (auto& [key, bound] : fallbackTextures) clear(bound);
+            auto clearImage = [id](ImageBinding& bound) { if (bound.id == id) bound = ImageBinding{}; };
+            std::for_each(boundImages.begin(), boundImages.end(), clearImage);
+            std::for_each(desiredImages.begin(), desiredImages.end(), clearImage);
+        }
+
+        void forgetBuffer(GLuint id) {
+            if (!id) return;
+            hazardTracker.forget(HazardResource::Buffer, id);
+            for (GLuint& bound : boundBuffers)
+                if (bound == id) bound = 0;
+            for (auto& [target, bound] : fallbackBuffers)
+                if (bound == id) bound = 0;
+            auto clear = [id](BufferRange& bound) { if (bound.id == id) bound = BufferRange{}; };
+            for (auto& bases : boundBases) std::for_each(bases.begin(), bases.end(), clear);
+            for (auto& bases : desiredBases) std::for_each(bases.begin(), bases.end(), clear);
+            for (auto& [key, bound] : fallbackBases) clear(bound);
+        }
+
+        void reset() {
+            boundBuffers.fill(0);
+            for (auto& bases : boundBases)
+                std::fill(bases.begin(), bases.end(), BufferRange{});
+            std::fill(boundTextures.begin(), boundTextures.end(), 0);
+            std::fill(boundTextureUnits.begin(), boundTextureUnits.end(), 0);
+            std::fill(boundImages.begin(), boundImages.end(), ImageBinding{});
+
+            fallbackBuffers.clear();
+            fallbackBases.clear();
+            fallbackTextures.clear();
+            fallbackTextureUnits.clear();
 
             boundVertexArray = 0;
             boundShader = 0;
             boundRenderbuffer = 0;
 
-            boundFramebuffer = 0;
             boundDrawFramebuffer = 0;
             boundReadFramebuffer = 0;
 
             activeTexUnit = 0;
+
+            hazardTracker.clearBindings();
+            syncDesired();
+            invalidateRenderState();
+        }
+
+        static constexpr GLuint bufferSlot(GLenum target) {
+            switch (target) {
+                case GL_ARRAY_BUFFER:              return 0;
+                case GL_ELEMENT_ARRAY_BUFFER:      return 1;
+                case GL_UNIFORM_BUFFER:            return 2;
+                case GL_SHADER_STORAGE_BUFFER:     return 3;
+                case GL_COPY_READ_BUFFER:          return 4;
+                case GL_COPY_WRITE_BUFFER:         return 5;
+                case GL_PIXEL_PACK_BUFFER:         return 6;
+                case GL_PIXEL_UNPACK_BUFFER:       return 7;
+                case GL_DRAW_INDIRECT_BUFFER:      return 8;
+                case GL_DISPATCH_INDIRECT_BUFFER:  return 9;
+                case GL_ATOMIC_COUNTER_BUFFER:     return 10;
+                case GL_TEXTURE_BUFFER:            return 11;
+                case GL_TRANSFORM_FEEDBACK_BUFFER: return 12;
+                case GL_QUERY_BUFFER:              return 13;
+                case GL_PARAMETER_BUFFER:          return 14;
+                default:                           return InvalidSlot;
+            }
         }
-    
+
+        static constexpr GLuint indexedSlot(GLenum target) {
+            switch (target) {
+                case GL_UNIFORM_BUFFER:            return 0;
+                case GL_SHADER_STORAGE_BUFFER:     return 1;
+                case GL_ATOMIC_COUNTER_BUFFER:     return 2;
+                case GL_TRANSFORM_FEEDBACK_BUFFER: return 3;
+                default:                           return InvalidSlot;
+            }
+        }
+
+        static constexpr GLuint textureSlot(GLenum target) {
+            switch (target) {
+                case GL_TEXTURE_2D:                   return 0;
+                case GL_TEXTURE_2D_ARRAY:             return 1;
+                case GL_TEXTURE_3D:                   return 2;
+                case GL_TEXTURE_CUBE_MAP:             return 3;
+                case GL_TEXTURE_CUBE_MAP_ARRAY:       return 4;
+                case GL_TEXTURE_1D:                   return 5;
+                case GL_TEXTURE_1D_ARRAY:             return 6;
+                case GL_TEXTURE_RECTANGLE:            return 7;
+                case GL_TEXTURE_BUFFER:               return 8;
+                case GL_TEXTURE_2D_MULTISAMPLE:       return 9;
+                case GL_TEXTURE_2D_MULTISAMPLE_ARRAY: return 10;
+                default:                              return InvalidSlot;
+            }
+        }
+
     private:
-        static inline std::unordered_map<GLenum, GLuint> boundBuffers;
-        static inline std::unordered_map<std::pair<GLenum, GLuint>, GLuint, pair_hash> boundBases;
+        void commitBufferBase(GLenum target, GLuint index, GLuint id) {
+            BufferRange& bound = baseBinding(target, index);
+            BufferRange range{id, 0, 0};
+            bool issue = bound != range;
+            GLBALLISTIC_STAT(stats.bufferBase.record(issue));
+            if (issue) {
+                glBindBufferBase(target, index, id);
+                bound = range;
+                bufferBinding(target) = id;
+            }
+        }
+
+        void commitBufferRange(GLenum target, GLuint index, const BufferRange& range) {
+            BufferRange& bound = baseBinding(target, index);
+            bool issue = bound != range;
+            GLBALLISTIC_STAT(stats.bufferRange.record(issue));
+            if (issue) {
+                glBindBufferRange(target, index, range.id, range.offset, range.size);
+                bound = range;
+                bufferBinding(target) = range.id;
+            }
+        }
+
+        void commitBuffersBase(GLenum target, GLuint first, std::span<const GLuint> ids) {
+            size_t begin = 0, end = ids.size();
+            while (begin < end && baseBinding(target, first + begin) == BufferRange{ids[begin], 0, 0}) begin++;
+            while (end > begin && baseBinding(target, first + end - 1) == BufferRange{ids[end - 1], 0, 0}) end--;
+            GLBALLISTIC_STAT(stats.multiBind.record(begin != end));
+            if (begin == end) return;
+
+            if (!(GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_multi_bind)) {
+                for (size_t i = begin; i < end; i++)
+                    commitBufferBase(target, first + static_cast<GLuint>(i), ids[i]);
+                return;
+            }
 
-        static inline GLuint boundVertexArray = 0;
-        static inline GLuint boundShader = 0;
-        static inline GLuint boundRenderbuffer = 0;
+            glBindBuffersBase(target, first + static_cast<GLuint>(begin), static_cast<GLsizei>(end - begin), ids.data() + begin);
+            for (size_t i = begin; i < end; i++)
+                baseBinding(target, first + static_cast<GLuint>(i)) = BufferRange{ids[i], 0, 0};
+        }
+
+        void commitBuffersRange(GLenum target, GLuint first, std::span<const BufferRange> ranges) {
+            size_t begin = 0, end = ranges.size();
+            while (begin < end && baseBinding(target, first + begin) == ranges[begin]) begin++;
+            while (end > begin && baseBinding(target, first + end - 1) == ranges[end - 1]) end--;
+            GLBALLISTIC_STAT(stats.multiBind.record(begin != end));
+            if (begin == end) return;
 
-        static inline GLuint boundFramebuffer = 0;
-        static inline GLuint boundDrawFramebuffer = 0;
-        static inline GLuint boundReadFramebuffer = 0;
+            if (!(GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_multi_bind)) {
+                for (size_t i = begin; i < end; i++)
+                    commitBufferRange(target, first + static_cast<GLuint>(i), ranges[i]);
+                return;
+            }
+
+            multiBindIds.clear();
+            multiBindOffsets.clear();
+            multiBindSizes.clear();
+            for (size_t i = begin; i < end; i++) {
+                multiBindIds.push_back(ranges[i].id);
+                multiBindOffsets.push_back(ranges[i].offset);
+                multiBindSizes.push_back(ranges[i].size);
+                baseBinding(target, first + static_cast<GLuint>(i)) = ranges[i];
+            }
+
+            glBindBuffersRange(target, first + static_cast<GLuint>(begin), static_cast<GLsizei>(end - begin),
+                               multiBindIds.data(), multiBindOffsets.data(), multiBindSizes.data());
+        }
+
+        // Conservative: everything bound counts as an input of the draw or dispatch, whether
+        // the current program reads it or not, so a pending write to a texture or buffer that
+        // is merely left bound still gets its barrier. Unbind such resources to avoid that.
+        // Only the dense tables are scanned; units beyond the driver limits queried in init()
+        // live in the fallback maps and are not checked.
+        void requireShaderInputs() {
+            for (GLuint id : boundTextureUnits)
+                hazardTracker.require(HazardResource::Texture, id, GL_TEXTURE_FETCH_BARRIER_BIT);
+            for (GLuint id : boundTextures)
+                hazardTracker.require(HazardResource::Texture, id, GL_TEXTURE_FETCH_BARRIER_BIT);
+            for (const ImageBinding& b : boundImages)
+                hazardTracker.require(HazardResource::Texture, b.id, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            for (const BufferRange& r : boundBases[indexedSlot(GL_UNIFORM_BUFFER)])
+                hazardTracker.require(HazardResource::Buffer, r.id, GL_UNIFORM_BARRIER_BIT);
+            for (const BufferRange& r : boundBases[indexedSlot(GL_SHADER_STORAGE_BUFFER)])
+                hazardTracker.require(HazardResource::Buffer, r.id, GL_SHADER_STORAGE_BARRIER_BIT);
+            for (const BufferRange& r : boundBases[indexedSlot(GL_ATOMIC_COUNTER_BUFFER)])
+                hazardTracker.require(HazardResource::Buffer, r.id, GL_ATOMIC_COUNTER_BARRIER_BIT);
+        }
 
-        static inline GLuint activeTexUnit = 0;
-        static inline std::unordered_map<std::pair<GLenum, GLuint>, GLuint, pair_hash> boundTextures;
-        static inline std::unordered_map<GLuint, GLuint> boundTextureUnits;
+        // The caches keep no access for buffer bindings, so every storage buffer bound before
+        // tracking was switched on counts as written until it is bound again.
+        void rebuildHazardBindings() {
+            hazardTracker.clearBindings();
+
+            const std::vector<ImageBinding>& images = deferredMode ? desiredImages : boundImages;
+            for (size_t unit = 0; unit < images.size(); unit++) {
+                if (images[unit].id)
+                    hazardTracker.bindImage(static_cast<GLuint>(unit), images[unit].id, images[unit].access);
+            }
+
+            for (size_t slot = 0; slot < IndexedTargetCount; slot++) {
+                GLenum target = indexedTargets[slot];
+                if (target != GL_SHADER_STORAGE_BUFFER && target != GL_ATOMIC_COUNTER_BUFFER) continue;
+                const std::vector<BufferRange>& bases = deferredMode ? desiredBases[slot] : boundBases[slot];
+                for (size_t index = 0; index < bases.size(); index++) {
+                    if (bases[index].id)
+                        hazardTracker.bindStorage(target, static_cast<GLuint>(index), bases[index].id, GL_READ_WRITE);
+                }
+            }
+
+            for (const auto& [key, range] : fallbackBases) {
+                if (range.id)
+                    hazardTracker.bindStorage(key.first, key.second, range.id, GL_READ_WRITE);
+            }
+        }
+
+        // Reads back the vertex array and draw framebuffer the tracker does not know yet. Both
+        // are bound by the time syncDraw() runs, so this is one query per binding slot the first
+        // time each container is drawn with after tracking was switched on.
+        void learnContainers() {
+            if (!hazardTracker.knowsVertexArray(boundVertexArray)) {
+                GLint count = 0, elements = 0;
+                glGetIntegerv(GL_MAX_VERTEX_ATTRIB_BINDINGS, &count);
+                std::vector<GLuint> vertex(static_cast<size_t>(std::max(count, 0)), 0);
+                for (GLuint i = 0; i < vertex.size(); i++) {
+                    GLint id = 0;
+                    glGetIntegeri_v(GL_VERTEX_BINDING_BUFFER, i, &id);
+                    vertex[i] = static_cast<GLuint>(id);
+                }
+                glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elements);
+                hazardTracker.setVertexArray(boundVertexArray, std::move(vertex), static_cast<GLuint>(elements));
+            }
+
+            if (!hazardTracker.knowsFramebuffer(boundDrawFramebuffer)) {
+                // Slot 0 is the depth attachment and slot n + 1 color attachment n, as in Framebuffer.
+                GLint count = 0;
+                glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &count);
+                std::vector<GLuint> textures(static_cast<size_t>(std::max(count, 0)) + 1, 0);
+                for (GLuint slot = 0; slot < textures.size(); slot++) {
+                    GLenum attachment = slot ? GL_COLOR_ATTACHMENT0 + slot - 1 : GL_DEPTH_ATTACHMENT;
+                    GLint type = GL_NONE, id = 0;
+                    glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, attachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+                    if (type != GL_TEXTURE) continue;
+                    glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, attachment, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME, &id);
+                    textures[slot] = static_cast<GLuint>(id);
+                }
+                hazardTracker.setFramebuffer(boundDrawFramebuffer, std::move(textures));
+            }
+        }
+
+        void syncDesired() {
+            desiredShader = boundShader;
+            desiredVertexArray = boundVertexArray;
+            desiredTextures = boundTextureUnits;
+            desiredImages = boundImages;
+            desiredBases = boundBases;
+
+            dirtyTextures.clear();
+            dirtyImages.clear();
+            for (auto& dirty : dirtyBases)
+                dirty.clear();
+        }
+
+        bool deferBase(GLenum target, GLuint index, const BufferRange& range) {
+            GLuint slot = indexedSlot(target);
+            if (slot == InvalidSlot || index >= desiredBases[slot].size()) return false;
+            desiredBases[slot][index] = range;
+            dirtyBases[slot].add(index);
+            GLBALLISTIC_STAT(stats.deferred++);
+            return true;
+        }
+
+        void flushTextures() {
+            if (dirtyTextures.empty()) return;
+
+            GLuint begin = dirtyTextures.begin, end = dirtyTextures.end;
+            dirtyTextures.clear();
+            while (begin < end && boundTextureUnits[begin] == desiredTextures[begin]) begin++;
+            while (end > begin && boundTextureUnits[end - 1] == desiredTextures[end - 1]) end--;
+            if (begin == end) return;
+
+            if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_multi_bind) {
+                GLBALLISTIC_STAT(stats.multiBind.issued++);
+                glBindTextures(begin, static_cast<GLsizei>(end - begin), desiredTextures.data() + begin);
+                std::copy(desiredTextures.begin() + begin, desiredTextures.begin() + end, boundTextureUnits.begin() + begin);
+                return;
+            }
+
+            for (GLuint unit = begin; unit < end; unit++) {
+                bool issue = boundTextureUnits[unit] != desiredTextures[unit];
+                GLBALLISTIC_STAT(stats.texture.record(issue));
+                if (issue) {
+                    glBindTextureUnit(unit, desiredTextures[unit]);
+                    boundTextureUnits[unit] = desiredTextures[unit];
+                }
+            }
+        }
+
+        // glBindImageTextures always binds level 0, all layers, read-write access and the
+        // texture's own format, so it is only used when every changed unit asks for exactly that.
+        void flushImages() {
+            if (dirtyImages.empty()) return;
+
+            GLuint begin = dirtyImages.begin, end = dirtyImages.end;
+            dirtyImages.clear();
+            while (begin < end && boundImages[begin] == desiredImages[begin]) begin++;
+            while (end > begin && boundImages[end - 1] == desiredImages[end - 1]) end--;
+            if (begin == end) return;
+
+            // glBindImageTextures binds level 0 of every texture layered, at layer 0, read-write
+            // and in the texture's own internal format, and resets units given 0 to the default
+            // binding. Anything else in the range takes the per-unit path.
+            bool batchable = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_multi_bind;
+            for (GLuint unit = begin; unit < end && batchable; unit++) {
+                const ImageBinding& b = desiredImages[unit];
+                if (b.id == 0)
+                    batchable = b == ImageBinding{};
+                else
+                    batchable = b.level == 0 && b.layered == GL_TRUE && b.layer == 0 && b.access == GL_READ_WRITE && b.textureFormat != GL_NONE && b.format == b.textureFormat;
+            }
+
+            if (batchable) {
+                GLBALLISTIC_STAT(stats.multiBind.issued++);
+                multiBindIds.clear();
+                for (GLuint unit = begin; unit < end; unit++)
+                    multiBindIds.push_back(desiredImages[unit].id);
+                glBindImageTextures(begin, static_cast<GLsizei>(end - begin), multiBindIds.data());
+                std::copy(desiredImages.begin() + begin, desiredImages.begin() + end, boundImages.begin() + begin);
+                return;
+            }
+
+            for (GLuint unit = begin; unit < end; unit++) {
+                const ImageBinding& b = desiredImages[unit];
+                bool issue = boundImages[unit] != b;
+                GLBALLISTIC_STAT(stats.image.record(issue));
+                if (issue) {
+                    glBindImageTexture(unit, b.id, b.level, b.layered, b.layer, b.access, b.format);
+                    boundImages[unit] = b;
+                }
+            }
+        }
+
+        // Splits the dirty range into runs of whole-buffer and ranged bindings, since
+        // glBindBuffersRange needs an explicit size for every non-zero buffer.
+        void flushBases(size_t slot) {
+            DirtyRange& dirty = dirtyBases[slot];
+            if (dirty.empty()) return;
+
+            GLenum target = indexedTargets[slot];
+            const auto& desired = desiredBases[slot];
+            GLuint runStart = dirty.begin;
+
+            for (GLuint i = dirty.begin; i < dirty.end; i++) {
+                bool isBase = desired[i].size == 0;
+                bool last = i + 1 == dirty.end;
+                if (!last && (desired[i + 1].size == 0) == isBase) continue;
+
+                size_t count = i + 1 - runStart;
+                if (isBase) {
+                    multiBindBaseIds.clear();
+                    for (GLuint j = runStart; j <= i; j++)
+                        multiBindBaseIds.push_back(desired[j].id);
+                    commitBuffersBase(target, runStart, multiBindBaseIds);
+                } else {
+                    commitBuffersRange(target, runStart, std::span<const BufferRange>(desired.data() + runStart, count));
+                }
+                runStart = i + 1;
+            }
+
+            dirty.clear();
+        }
+
+        GLuint& bufferBinding(GLenum target) {
+            GLuint slot = bufferSlot(target);
+            if (slot != InvalidSlot) return boundBuffers[slot];
+            return fallbackBuffers[target];
+        }
+
+        BufferRange& baseBinding(GLenum target, GLuint index) {
+            GLuint slot = indexedSlot(target);
+            if (slot != InvalidSlot && index < boundBases[slot].size()) return boundBases[slot][index];
+            return fallbackBases[std::make_pair(target, index)];
+        }
+
+        GLuint& textureUnitBinding(GLuint unit) {
+            if (unit < boundTextureUnits.size()) return boundTextureUnits[unit];
+            return fallbackTextureUnits[unit];
+        }
+
+        GLuint& textureBinding(GLuint unit, GLenum target) {
+            GLuint slot = textureSlot(target);
+            if (slot != InvalidSlot && unit < textureUnitCount) return boundTextures[unit * TextureTargetCount + slot];
+            return fallbackTextures[std::make_pair(target, unit)];
+        }
+
+        std::array<GLuint, BufferTargetCount> boundBuffers{};
+        std::array<std::vector<BufferRange>, IndexedTargetCount> boundBases{
+            std::vector<BufferRange>(DefaultSlotCount), std::vector<BufferRange>(DefaultSlotCount),
+            std::vector<BufferRange>(DefaultSlotCount), std::vector<BufferRange>(DefaultSlotCount)
+        };
+        std::vector<GLuint> multiBindIds;
+        std::vector<GLuint> multiBindBaseIds;
+        std::vector<GLintptr> multiBindOffsets;
+        std::vector<GLsizeiptr> multiBindSizes;
+
+        GLuint boundVertexArray = 0;
+        GLuint boundShader = 0;
+        GLuint boundRenderbuffer = 0;
+
+        GLuint boundDrawFramebuffer = 0;
+        GLuint boundReadFramebuffer = 0;
+
+        GLuint activeTexUnit = 0;
+        GLuint textureUnitCount = DefaultSlotCount;
+        std::vector<GLuint> boundTextureUnits = std::vector<GLuint>(DefaultSlotCount);
+        std::vector<GLuint> boundTextures = std::vector<GLuint>(DefaultSlotCount * TextureTargetCount);
+        std::vector<ImageBinding> boundImages = std::vector<ImageBinding>(DefaultSlotCount);
+
+        static constexpr GLenum indexedTargets[IndexedTargetCount] = {
+            GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_ATOMIC_COUNTER_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER
+        };
+
+        bool deferredMode = false;
+        GLuint desiredShader = 0;
+        GLuint desiredVertexArray = 0;
+        std::vector<GLuint> desiredTextures;
+        std::vector<ImageBinding> desiredImages;
+        std::array<std::vector<BufferRange>, IndexedTargetCount> desiredBases;
+        DirtyRange dirtyTextures;
+        DirtyRange dirtyImages;
+        std::array<DirtyRange, IndexedTargetCount> dirtyBases;
+
+        static constexpr GLuint AllEnables = (1u << RenderState::EnableCount) - 1;
+
+        RenderState renderState = RenderState::unknown();
+        GLuint knownEnables = 0;
+        size_t appliedPipeline = 0;
+
+        ObjectNames objectNames;
+        HazardTracker hazardTracker;
+
+        StateStats stats;
+        StateStats lastFrame;
+        uint64_t frameNumber = 0;
+        std::array<GLfloat, 4> clearColorValue{
+            std::numeric_limits<GLfloat>::quiet_NaN(), std::numeric_limits<GLfloat>::quiet_NaN(),
+            std::numeric_limits<GLfloat>::quiet_NaN(), std::numeric_limits<GLfloat>::quiet_NaN()
+        };
+
+        std::unordered_map<GLenum, GLuint> fallbackBuffers;
+        std::unordered_map<std::pair<GLenum, GLuint>, BufferRange, pair_hash> fallbackBases;
+        std::unordered_map<std::pair<GLenum, GLuint>, GLuint, pair_hash> fallbackTextures;
+        std::unordered_map<GLuint, GLuint> fallbackTextureUnits;
+    };
+
+    // Static entry points used by the wrappers; they route to the context that is current on
+    // the calling thread. Without GLBALLISTIC_MULTI_CONTEXT there is a single process-wide
+    // Context and current() is a plain global access. With it, every thread gets its own
+    // Context, and makeCurrent() selects an explicit one (e.g. after switching GL contexts).
+    class State {
+    public:
+#ifdef GLBALLISTIC_MULTI_CONTEXT
+        static Context& current() { return currentContext ? *currentContext : threadContext; }
+        static void makeCurrent(Context* context) { currentContext = context; }
+#else
+        static Context& current() { return mainContext; }
+        static void makeCurrent(Context*) {}
+#endif
+
+        static void init() { current().init(); }
+        static void reset() { current().reset(); }
+
+        static bool setDeferred(bool enabled) { return current().setDeferred(enabled); }
+        static bool deferred() { return current().deferred(); }
+        static void flush() { current().flush(); }
+        static void commitShader() { current().commitShader(); }
+
+        static void bindBuffer(GLenum target, GLuint id) { current().bindBuffer(target, id); }
+        static void bindBufferBase(GLenum target, GLuint index, GLuint id, GLenum access = GL_READ_WRITE) { current().bindBufferBase(target, index, id, access); }
+        static void bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr size, GLenum access = GL_READ_WRITE) { current().bindBufferRange(target, index, id, offset, size, access); }
+        static void bindBuffersBase(GLenum target, GLuint first, std::span<const GLuint> ids, GLenum access = GL_READ_WRITE) { current().bindBuffersBase(target, first, ids, access); }
+        static void bindBuffersRange(GLenum target, GLuint first, std::span<const BufferRange> ranges, GLenum access = GL_READ_WRITE) { current().bindBuffersRange(target, first, ranges, access); }
+        static void bindVertexArray(GLuint id) { current().bindVertexArray(id); }
+        static void bindShader(GLuint id) { current().bindShader(id); }
+        static void bindTexture(GLuint unit, GLenum target, GLuint id) { current().bindTexture(unit, target, id); }
+        static GLuint boundTexture(GLuint unit, GLenum target) { return current().boundTexture(unit, target); }
+        static void bindImageTexture(GLuint unit, GLuint id, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format, GLenum textureFormat = GL_NONE) { current().bindImageTexture(unit, id, level, layered, layer, access, format, textureFormat); }
+        static void activeTexture(GLuint unit) { current().activeTexture(unit); }
+        static void bindRenderbuffer(GLuint id) { current().bindRenderbuffer(id); }
+        static void bindFramebuffer(GLuint id, GLenum target = GL_FRAMEBUFFER) { current().bindFramebuffer(id, target); }
+        static GLuint boundFramebuffer(GLenum target = GL_DRAW_FRAMEBUFFER) { return current().boundFramebuffer(target); }
+        static void forgetTexture(GLuint id) { current().forgetTexture(id); }
+        static void forgetBuffer(GLuint id) { current().forgetBuffer(id); }
+
+        static void enable(GLenum cap, bool on = true) { current().enable(cap, on); }
+        static void setEnables(GLuint enables, GLuint mask = ~0u) { current().setEnables(enables, mask); }
+        static void blendFunc(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha) { current().blendFunc(srcRGB, dstRGB, srcAlpha, dstAlpha); }
+        static void blendEquation(GLenum opRGB, GLenum opAlpha) { current().blendEquation(opRGB, opAlpha); }
+        static void depthFunc(GLenum func) { current().depthFunc(func); }
+        static void depthMask(bool write) { current().depthMask(write); }
+        static void stencilFunc(GLenum func, GLint ref, GLuint mask) { current().stencilFunc(func, ref, mask); }
+        static void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) { current().stencilOp(sfail, dpfail, dppass); }
+        static void stencilMask(GLuint mask) { current().stencilMask(mask); }
+        static void cullFace(GLenum face) { current().cullFace(face); }
+        static void frontFace(GLenum winding) { current().frontFace(winding); }
+        static void polygonMode(GLenum mode) { current().polygonMode(mode); }
+        static void polygonOffset(GLfloat factor, GLfloat units) { current().polygonOffset(factor, units); }
+        static void colorMask(GLuint mask) { current().colorMask(mask); }
+        static void viewport(const Rect& rect) { current().viewport(rect); }
+        static void scissor(const Rect& rect) { current().scissor(rect); }
+        static void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) { current().clearColor(r, g, b, a); }
+        static void apply(const RenderState& rs) { current().apply(rs); }
+        static void apply(const PipelineState& pipeline) { current().apply(pipeline); }
+        static const RenderState& renderStateCache() { return current().renderStateCache(); }
+        static void invalidateRenderState() { current().invalidateRenderState(); }
+
+        static void beginFrame() { current().beginFrame(); }
+        static void endFrame() { current().endFrame(); }
+        static ObjectNames& names() { return current().names(); }
+        static void setHazardMode(HazardMode mode) { current().setHazardMode(mode); }
+        static HazardTracker& hazards() { return current().hazards(); }
+        static void syncDraw(bool indexed, bool indirect = false) { current().syncDraw(indexed, indirect); }
+        static void syncDispatch() { current().syncDispatch(); }
+        static void syncBuffer(GLuint id, const char* consumer, GLbitfield bit = GL_BUFFER_UPDATE_BARRIER_BIT) { current().syncBuffer(id, consumer, bit); }
+        static void syncTexture(GLuint id, const char* consumer, GLbitfield bit = GL_TEXTURE_UPDATE_BARRIER_BIT) { current().syncTexture(id, consumer, bit); }
+        static void memoryBarrier(GLbitfield bits) { current().memoryBarrier(bits); }
+        static const StateStats& stats() { return current().frameStats(); }
+        static const StateStats& lastFrameStats() { return current().lastFrameStats(); }
+        static void countUpload(uint64_t bytes) { current().countUpload(bytes); }
+        static void countDraw() { current().countDraw(); }
+        static void countDispatch() { current().countDispatch(); }
+        static void countCopy(uint64_t bytes) { current().countCopy(bytes); }
+        static void countClear() { current().countClear(); }
+        static void countMap() { current().countMap(); }
+        static void countUniform(bool issued) { current().countUniform(issued); }
+
+    private:
+#ifdef GLBALLISTIC_MULTI_CONTEXT
+        static inline thread_local Context threadContext;
+        static inline thread_local Context* currentContext = nullptr;
+#else
+        static inline Context mainContext;
+#endif
     };
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/Fence.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+    struct StreamAllocation {
+        void* data{nullptr};
+        GLintptr offset{0};
+        GLsizeiptr size{0};
+
+        explicit operator bool() const { return data != nullptr; }
+
+        template<typename T>
+        T* as() const { return static_cast<T*>(data); }
+    };
+
+    // N-buffered ring of per-frame regions inside one persistently mapped buffer. Each frame
+    // sub-allocates from its own region, and a fence placed at endFrame() keeps the region
+    // from being rewritten until the GPU has consumed it. Without ARB_buffer_storage the ring
+    // stages writes in client memory and uploads each frame's used range in one call.
+    class StreamBuffer {
+    public:
+        StreamBuffer() = default;
+        ~StreamBuffer() { destroy(); }
+
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+        StreamBuffer(StreamBuffer&& other) noexcept { *this = std::move(other); }
+        StreamBuffer& operator=(StreamBuffer&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                m_buffer = std::move(other.m_buffer);
+                m_mapped = other.m_mapped;
+                m_staging = std::move(other.m_staging);
+                m_fences = std::move(other.m_fences);
+                m_frameSize = other.m_frameSize;
+                m_alignment = other.m_alignment;
+                m_frame = other.m_frame;
+                m_head = other.m_head;
+                m_coherent = other.m_coherent;
+                other.m_mapped = nullptr;
+                other.m_frameSize = 0;
+                other.m_head = 0;
+            }
+            return *this;
+        }
+
+        void create(GLenum target, GLsizeiptr frameSize, GLuint frames = 3, bool coherent = true) {
+            if (m_buffer.get()) return;
+
+            m_alignment = BufferOffsetAlignment(target);
+            m_frameSize = alignUp(frameSize, m_alignment);
+            m_coherent = coherent;
+            m_frame = 0;
+            m_head = 0;
+            m_fences.clear();
+            m_fences.resize(frames);
+
+            GLsizeiptr total = m_frameSize * frames;
+            m_buffer.create(target);
+
+            if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | (coherent ? GL_MAP_COHERENT_BIT : 0);
+                m_buffer.storage(total, nullptr, flags);
+                m_mapped = static_cast<unsigned char*>(m_buffer.mapRange(0, total, flags | (coherent ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT)));
+            } else {
+                m_buffer.data(total, nullptr, GL_STREAM_DRAW);
+                m_staging.resize(static_cast<size_t>(total));
+                m_mapped = m_staging.data();
+            }
+        }
+
+        void destroy() {
+            m_fences.clear();
+            if (m_mapped && m_staging.empty())
+                m_buffer.unmap();
+            m_mapped = nullptr;
+            m_staging.clear();
+            m_buffer.destroy();
+            m_frameSize = 0;
+            m_head = 0;
+        }
+
+        // Moves to the next region, blocking only if the GPU is still reading what was
+        // written there frames() frames ago.
+        void beginFrame() {
+            m_frame = (m_frame + 1) % static_cast<GLuint>(m_fences.size());
+            m_head = 0;
+
+            Fence& fence = m_fences[m_frame];
+            fence.wait();
+            fence.destroy();
+        }
+
+        void endFrame() {
+            if (m_head > 0) {
+                if (!m_staging.empty())
+                    m_buffer.update(frameOffset(), m_head, m_mapped + frameOffset());
+                else if (!m_coherent)
+                    m_buffer.flush(frameOffset(), m_head);
+            }
+
+            m_fences[m_frame].create();
+        }
+
+        // Returns an empty allocation when the current frame's region is exhausted.
+        StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 0) {
+            GLsizeiptr start = alignUp(m_head, alignment > 0 ? alignment : m_alignment);
+            if (!m_mapped || start + size > m_frameSize) return {};
+
+            m_head = start + size;
+            GLintptr offset = frameOffset() + start;
+            return {m_mapped + offset, offset, size};
+        }
+
+        template<typename T>
+        StreamAllocation push(const T& value, GLsizeiptr alignment = 0) {
+            StreamAllocation alloc = allocate(sizeof(T), alignment);
+            if (alloc) *alloc.as<T>() = value;
+            return alloc;
+        }
+
+        void bindRange(GLenum target, GLuint index, const StreamAllocation& alloc) const {
+            m_buffer.bindRange(target, index, alloc.offset, alloc.size);
+        }
+
+        Buffer& buffer() { return m_buffer; }
+        const Buffer& buffer() const { return m_buffer; }
+        GLuint get() const { return m_buffer.get(); }
+
+        GLsizeiptr frameSize() const { return m_frameSize; }
+        GLsizeiptr used() const { return m_head; }
+        GLuint frames() const { return static_cast<GLuint>(m_fences.size()); }
+        bool persistent() const { return m_mapped && m_staging.empty(); }
+
+    private:
+        Buffer m_buffer;
+        unsigned char* m_mapped{nullptr};
+        std::vector<unsigned char> m_staging;
+        std::vector<Fence> m_fences;
+        GLsizeiptr m_frameSize{0};
+        GLsizeiptr m_alignment{1};
+        GLuint m_frame{0};
+        GLsizeiptr m_head{0};
+        bool m_coherent{true};
+
+        GLintptr frameOffset() const { return static_cast<GLintptr>(m_frame) * m_frameSize; }
+
+        static GLsizeiptr alignUp(GLsizeiptr value, GLsizeiptr alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    };
+
+}
\ No newline at end of file
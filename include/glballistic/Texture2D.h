@@ -1,6 +1,11 @@
 #pragma once
 #include <glad/glad.h>
 #include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Profiler.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace gl {
 
@@ -17,6 +22,17 @@ namespace gl {
             if (this != &other) {
                 destroy();
                 m_id = other.m_id;
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_storageWidth = other.m_storageWidth;
+                m_storageHeight = other.m_storageHeight;
+                m_levels = other.m_levels;
+                m_requestedLevels = other.m_requestedLevels;
+                m_internalFormat = other.m_internalFormat;
+                m_format = other.m_format;
+                m_type = other.m_type;
+                m_parameters = other.m_parameters;
+                m_hasParameters = other.m_hasParameters;
                 other.m_id = 0;
             }
             return *this;
@@ -25,25 +41,25 @@ namespace gl {
         void create(GLsizei width, GLsizei height, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1) {
             if (m_id) return;
 
+            m_id = State::names().textures2D.acquire();
             if (GLAD_GL_VERSION_4_5) {
-                glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
                 glTextureStorage2D(m_id, levels, internalFormat, width, height);
             } else {
-                glGenTextures(1, &m_id);
                 bind();
                 glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
             }
 
-            m_width = width;
-            m_height = height;
+            m_width = m_storageWidth = width;
+            m_height = m_storageHeight = height;
             m_internalFormat = internalFormat;
             m_format = format;
             m_type = type;
-            m_levels = levels;
+            m_levels = m_requestedLevels = levels;
         }
 
         void destroy() {
             if (!m_id) return;
+            State::forgetTexture(m_id);
             glDeleteTextures(1, &m_id);
             m_id = 0;
         }
@@ -53,23 +69,41 @@ namespace gl {
 
         void bind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_2D, m_id); }
         void unbind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_2D, 0); }
-        void bindImage(GLuint unit, GLenum access = GL_READ_WRITE, GLint level = 0) const { glBindImageTexture(unit, m_id, level, GL_FALSE, 0, access, m_internalFormat); }
+        // Bound layered: a 2D level has a single layer, so this is the same image, and it matches
+        // what glBindImageTextures records when State batches the binding.
+        void bindImage(GLuint unit, GLenum access = GL_READ_WRITE, GLint level = 0) const { State::bindImageTexture(unit, m_id, level, GL_TRUE, 0, access, m_internalFormat, m_internalFormat); }
 
-        void setData(const void* data) const {
+        void setData(const void* data) const { setSubData(0, 0, 0, m_width, m_height, data); }
+
+        // With a GL_PIXEL_UNPACK_BUFFER bound, data is a byte offset into that buffer.
+        void setSubData(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, const void* data) const {
+            State::syncTexture(m_id, "Texture2D::setSubData");
+            GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(PixelSize(m_format, m_type))));
             if (GLAD_GL_VERSION_4_5) {
-                glTextureSubImage2D(m_id, 0, 0, 0, m_width, m_height, m_format, m_type, data);
+                glTextureSubImage2D(m_id, level, x, y, width, height, m_format, m_type, data);
             } else {
                 bind();
-                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, m_format, m_type, data);
+                glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, m_format, m_type, data);
             }
         }
 
+        // Reads level 0 of the logical area, tightly packed apart from 4-byte row alignment.
         void getData(void* data) const {
-            bind();
-            glGetTexImage(GL_TEXTURE_2D, 0, m_format, m_type, data);
+            State::syncTexture(m_id, "Texture2D::getData");
+            if (m_width != m_storageWidth || m_height != m_storageHeight) {
+                getLogicalData(data);
+                return;
+            }
+            if (GLAD_GL_VERSION_4_5) {
+                glGetTextureImage(m_id, 0, m_format, m_type, dataSize(0), data);
+            } else {
+                bind();
+                glGetTexImage(GL_TEXTURE_2D, 0, m_format, m_type, data);
+            }
         }
 
         void generateMipmaps() const {
+            State::syncTexture(m_id, "Texture2D::generateMipmaps");
             if (GLAD_GL_VERSION_4_5) {
                 glGenerateTextureMipmap(m_id);
             } else {
@@ -78,7 +112,10 @@ namespace gl {
             }
         }
 
+        // Remembered so they carry over when resize() moves the texture to new storage.
         void setParameters(GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT) const {
+            m_parameters = {minFilter, magFilter, wrapS, wrapT};
+            m_hasParameters = true;
             if (GLAD_GL_VERSION_4_5) {
                 glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, minFilter);
                 glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, magFilter);
@@ -93,21 +130,38 @@ namespace gl {
             }
         }
 
-        void resize(GLsizei width, GLsizei height) {
-            if (!m_id) return;
+        // Sets the logical size. Immutable storage cannot be respecified, so the texture is
+        // only reallocated when the storage has to grow or is less than half used, following
+        // TargetCapacity(); otherwise the new size is just a smaller region of the existing
+        // allocation, starting at texel (0, 0). A reallocation replaces the GL object, so get()
+        // changes and framebuffers must re-attach (Framebuffer::resize does). The common area
+        // of level contents is preserved with GL 4.3 / ARB_copy_image. Returns whether the
+        // texture was reallocated.
+        bool resize(GLsizei width, GLsizei height) {
+            if (!m_id) return false;
 
-            if (width == m_width && height == m_height)
-                return;
+            GLsizei storageWidth = TargetCapacity(m_storageWidth, width);
+            GLsizei storageHeight = TargetCapacity(m_storageHeight, height);
+            bool reallocate = storageWidth != m_storageWidth || storageHeight != m_storageHeight;
+            if (reallocate)
+                reallocateStorage(storageWidth, storageHeight);
 
             m_width = width;
             m_height = height;
+            return reallocate;
+        }
 
-            if (GLAD_GL_VERSION_4_5) {
-                glTextureStorage2D(m_id, m_levels, m_internalFormat, width, height);
-            } else {
-                bind();
-                glTexStorage2D(GL_TEXTURE_2D, m_levels, m_internalFormat, width, height);
-            }
+        // Grows the storage to at least width x height without changing the logical size.
+        bool reserve(GLsizei width, GLsizei height) {
+            if (!m_id || (width <= m_storageWidth && height <= m_storageHeight)) return false;
+            reallocateStorage(std::max(width, m_storageWidth), std::max(height, m_storageHeight));
+            return true;
+        }
+
+        bool shrinkToFit() {
+            if (!m_id || (m_width == m_storageWidth && m_height == m_storageHeight)) return false;
+            reallocateStorage(m_width, m_height);
+            return true;
         }
 
         void label(const char* name) {
@@ -115,14 +169,101 @@ namespace gl {
                 glObjectLabel(GL_TEXTURE, m_id, -1, name);
         }
 
+        GLsizei levelWidth(GLint level) const { return std::max(1, m_width >> level); }
+        GLsizei levelHeight(GLint level) const { return std::max(1, m_height >> level); }
+        GLsizei dataSize(GLint level) const { return ((levelWidth(level) * PixelSize(m_format, m_type) + 3) & ~3) * levelHeight(level); }
+
         GLsizei width() const { return m_width; }
         GLsizei height() const { return m_height; }
+        GLsizei storageWidth() const { return m_storageWidth; }
+        GLsizei storageHeight() const { return m_storageHeight; }
+
+        // Largest texture coordinates inside the logical area; scale UVs by these when
+        // sampling a texture whose storage is larger than its size.
+        GLfloat uMax() const { return m_storageWidth ? static_cast<GLfloat>(m_width) / static_cast<GLfloat>(m_storageWidth) : 1.0f; }
+        GLfloat vMax() const { return m_storageHeight ? static_cast<GLfloat>(m_height) / static_cast<GLfloat>(m_storageHeight) : 1.0f; }
+        GLsizei levels() const { return m_levels; }
+        // The level count passed to create(); levels() may be lower after storage was reallocated
+        // at a size that cannot hold that many.
+        GLsizei requestedLevels() const { return m_requestedLevels; }
+        GLenum internalFormat() const { return m_internalFormat; }
+        GLenum format() const { return m_format; }
+        GLenum type() const { return m_type; }
 
     private:
+        struct Parameters {
+            GLenum minFilter, magFilter, wrapS, wrapT;
+        };
+
         GLuint m_id{0};
         GLsizei m_width{0}, m_height{0};
+        GLsizei m_storageWidth{0}, m_storageHeight{0};
         GLsizei m_levels{1};
-        GLenum m_internalFormat{0}, m_format{0}, m_type{0}; 
+        GLsizei m_requestedLevels{1};
+        GLenum m_internalFormat{0}, m_format{0}, m_type{0};
+        // Recorded by setParameters() so a reallocation can reapply them to the new object.
+        mutable Parameters m_parameters{GL_NEAREST_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT};
+        mutable bool m_hasParameters{false};
+
+        void reallocateStorage(GLsizei storageWidth, GLsizei storageHeight) {
+            GLBALLISTIC_PROFILE_ZONE("Texture2D::reallocate");
+            GLsizei maxLevels = 1;
+            while ((std::max(storageWidth, storageHeight) >> maxLevels) > 0) maxLevels++;
+            // Clamped for this allocation only, so a texture shrunk to a few texels gets its full
+            // mip chain back once it grows again.
+            GLsizei levels = std::min(m_requestedLevels, maxLevels);
+
+            // Resizes can happen mid-frame (Framebuffer::resize), so the non-DSA path puts back
+            // whatever the caller had on unit 0, or this texture's new name if it was the old one.
+            bool dsa = GLAD_GL_VERSION_4_5;
+            GLuint previous = dsa ? 0 : State::boundTexture(0, GL_TEXTURE_2D);
+            GLuint oldId = m_id;
+
+            GLuint id = State::names().textures2D.acquire();
+            if (dsa) {
+                glTextureStorage2D(id, levels, m_internalFormat, storageWidth, storageHeight);
+            } else {
+                State::bindTexture(0, GL_TEXTURE_2D, id);
+                glTexStorage2D(GL_TEXTURE_2D, levels, m_internalFormat, storageWidth, storageHeight);
+            }
+
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_copy_image) {
+                GLsizei keepWidth = std::min(m_width, storageWidth);
+                GLsizei keepHeight = std::min(m_height, storageHeight);
+                State::syncTexture(m_id, "Texture2D::resize");
+                for (GLint level = 0; level < std::min(levels, m_levels); level++) {
+                    glCopyImageSubData(m_id, GL_TEXTURE_2D, level, 0, 0, 0, id, GL_TEXTURE_2D, level, 0, 0, 0,
+                                       std::max(1, keepWidth >> level), std::max(1, keepHeight >> level), 1);
+                }
+            }
+
+            destroy();
+            m_id = id;
+            m_storageWidth = storageWidth;
+            m_storageHeight = storageHeight;
+            m_levels = levels;
+            if (m_hasParameters)
+                setParameters(m_parameters.minFilter, m_parameters.magFilter, m_parameters.wrapS, m_parameters.wrapT);
+
+            if (!dsa)
+                State::bindTexture(0, GL_TEXTURE_2D, previous == oldId ? id : previous);
+        }
+
+        void getLogicalData(void* data) const {
+            if (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_get_texture_sub_image) {
+                glGetTextureSubImage(m_id, 0, 0, 0, 0, m_width, m_height, 1, m_format, m_type, dataSize(0), data);
+                return;
+            }
+
+            GLsizei pixel = PixelSize(m_format, m_type);
+            GLsizei storagePitch = (m_storageWidth * pixel + 3) & ~3;
+            GLsizei pitch = (m_width * pixel + 3) & ~3;
+            std::vector<unsigned char> storage(static_cast<size_t>(storagePitch) * static_cast<size_t>(m_storageHeight));
+            bind();
+            glGetTexImage(GL_TEXTURE_2D, 0, m_format, m_type, storage.data());
+            for (GLsizei row = 0; row < m_height; row++)
+                std::memcpy(static_cast<unsigned char*>(data) + static_cast<size_t>(row) * pitch, storage.data() + static_cast<size_t>(row) * storagePitch, static_cast<size_t>(m_width * pixel));
+        }
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <algorithm>
+#include <utility>
+
+namespace gl {
+
+    // Immutable array of same-sized 2D layers behind one binding, sampled with sampler2DArray.
+    class Texture2DArray {
+    public:
+        Texture2DArray() = default;
+        ~Texture2DArray() { destroy(); }
+
+        Texture2DArray(const Texture2DArray&) = delete;
+        Texture2DArray& operator=(const Texture2DArray&) = delete;
+
+        Texture2DArray(Texture2DArray&& other) noexcept { *this = std::move(other); }
+        Texture2DArray& operator=(Texture2DArray&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                m_id = other.m_id;
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_layers = other.m_layers;
+                m_levels = other.m_levels;
+                m_internalFormat = other.m_internalFormat;
+                m_format = other.m_format;
+                m_type = other.m_type;
+                other.m_id = 0;
+            }
+            return *this;
+        }
+
+        void create(GLsizei width, GLsizei height, GLsizei layers, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1) {
+            if (m_id) return;
+
+            m_id = State::names().textures2DArray.acquire();
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureStorage3D(m_id, levels, internalFormat, width, height, layers);
+            } else {
+                bind();
+                glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, internalFormat, width, height, layers);
+            }
+
+            m_width = width;
+            m_height = height;
+            m_layers = layers;
+            m_internalFormat = internalFormat;
+            m_format = format;
+            m_type = type;
+            m_levels = levels;
+        }
+
+        void destroy() {
+            if (!m_id) return;
+            State::forgetTexture(m_id);
+            glDeleteTextures(1, &m_id);
+            m_id = 0;
+        }
+
+        bool valid() const { return m_id != 0 && glIsTexture(m_id); }
+        GLuint get() const { return m_id; }
+
+        void bind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_2D_ARRAY, m_id); }
+        void unbind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_2D_ARRAY, 0); }
+
+        // Binds every layer (image2DArray), or a single layer as a plain image2D when layer >= 0.
+        void bindImage(GLuint unit, GLenum access = GL_READ_WRITE, GLint level = 0, GLint layer = -1) const {
+            State::bindImageTexture(unit, m_id, level, layer < 0 ? GL_TRUE : GL_FALSE, std::max(layer, 0), access, m_internalFormat, m_internalFormat);
+        }
+
+        void setLayer(GLint layer, const void* data) const { setSubData(0, 0, 0, layer, m_width, m_height, 1, data); }
+
+        // With a GL_PIXEL_UNPACK_BUFFER bound, data is a byte offset into that buffer.
+        void setSubData(GLint level, GLint x, GLint y, GLint layer, GLsizei width, GLsizei height, GLsizei layers, const void* data) const {
+            State::syncTexture(m_id, "Texture2DArray::setSubData");
+            GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(layers) * static_cast<uint64_t>(PixelSize(m_format, m_type))));
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureSubImage3D(m_id, level, x, y, layer, width, height, layers, m_format, m_type, data);
+            } else {
+                bind();
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, x, y, layer, width, height, layers, m_format, m_type, data);
+            }
+        }
+
+        // Reads every layer of level, one after the other.
+        void getData(void* data, GLint level = 0) const {
+            State::syncTexture(m_id, "Texture2DArray::getData");
+            if (GLAD_GL_VERSION_4_5) {
+                glGetTextureImage(m_id, level, m_format, m_type, dataSize(level), data);
+            } else {
+                bind();
+                glGetTexImage(GL_TEXTURE_2D_ARRAY, level, m_format, m_type, data);
+            }
+        }
+
+        void generateMipmaps() const {
+            State::syncTexture(m_id, "Texture2DArray::generateMipmaps");
+            if (GLAD_GL_VERSION_4_5) {
+                glGenerateTextureMipmap(m_id);
+            } else {
+                bind();
+                glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+            }
+        }
+
+        void setParameters(GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT) const {
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, wrapS);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, wrapT);
+            } else {
+                bind();
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrapS);
+                glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrapT);
+            }
+        }
+
+        void label(const char* name) {
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
+                glObjectLabel(GL_TEXTURE, m_id, -1, name);
+        }
+
+        GLsizei levelWidth(GLint level) const { return std::max(1, m_width >> level); }
+        GLsizei levelHeight(GLint level) const { return std::max(1, m_height >> level); }
+        GLsizei layerSize(GLint level) const { return ((levelWidth(level) * PixelSize(m_format, m_type) + 3) & ~3) * levelHeight(level); }
+        GLsizei dataSize(GLint level) const { return layerSize(level) * m_layers; }
+
+        GLsizei width() const { return m_width; }
+        GLsizei height() const { return m_height; }
+        GLsizei layers() const { return m_layers; }
+        GLsizei levels() const { return m_levels; }
+        GLenum internalFormat() const { return m_internalFormat; }
+        GLenum format() const { return m_format; }
+        GLenum type() const { return m_type; }
+
+    private:
+        GLuint m_id{0};
+        GLsizei m_width{0}, m_height{0}, m_layers{0};
+        GLsizei m_levels{1};
+        GLenum m_internalFormat{0}, m_format{0}, m_type{0};
+    };
+
+}
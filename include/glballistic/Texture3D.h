@@ -0,0 +1,145 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <algorithm>
+#include <utility>
+
+namespace gl {
+
+    class Texture3D {
+    public:
+        Texture3D() = default;
+        ~Texture3D() { destroy(); }
+
+        Texture3D(const Texture3D&) = delete;
+        Texture3D& operator=(const Texture3D&) = delete;
+
+        Texture3D(Texture3D&& other) noexcept { *this = std::move(other); }
+        Texture3D& operator=(Texture3D&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                m_id = other.m_id;
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_depth = other.m_depth;
+                m_levels = other.m_levels;
+                m_internalFormat = other.m_internalFormat;
+                m_format = other.m_format;
+                m_type = other.m_type;
+                other.m_id = 0;
+            }
+            return *this;
+        }
+
+        void create(GLsizei width, GLsizei height, GLsizei depth, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1) {
+            if (m_id) return;
+
+            m_id = State::names().textures3D.acquire();
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureStorage3D(m_id, levels, internalFormat, width, height, depth);
+            } else {
+                bind();
+                glTexStorage3D(GL_TEXTURE_3D, levels, internalFormat, width, height, depth);
+            }
+
+            m_width = width;
+            m_height = height;
+            m_depth = depth;
+            m_internalFormat = internalFormat;
+            m_format = format;
+            m_type = type;
+            m_levels = levels;
+        }
+
+        void destroy() {
+            if (!m_id) return;
+            State::forgetTexture(m_id);
+            glDeleteTextures(1, &m_id);
+            m_id = 0;
+        }
+
+        bool valid() const { return m_id != 0 && glIsTexture(m_id); }
+        GLuint get() const { return m_id; }
+
+        void bind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_3D, m_id); }
+        void unbind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_3D, 0); }
+        void bindImage(GLuint unit, GLenum access = GL_READ_WRITE, GLint level = 0) const { State::bindImageTexture(unit, m_id, level, GL_TRUE, 0, access, m_internalFormat, m_internalFormat); }
+
+        void setData(const void* data) const { setSubData(0, 0, 0, 0, m_width, m_height, m_depth, data); }
+
+        // With a GL_PIXEL_UNPACK_BUFFER bound, data is a byte offset into that buffer.
+        void setSubData(GLint level, GLint x, GLint y, GLint z, GLsizei width, GLsizei height, GLsizei depth, const void* data) const {
+            State::syncTexture(m_id, "Texture3D::setSubData");
+            GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(depth) * static_cast<uint64_t>(PixelSize(m_format, m_type))));
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureSubImage3D(m_id, level, x, y, z, width, height, depth, m_format, m_type, data);
+            } else {
+                bind();
+                glTexSubImage3D(GL_TEXTURE_3D, level, x, y, z, width, height, depth, m_format, m_type, data);
+            }
+        }
+
+        void getData(void* data, GLint level = 0) const {
+            State::syncTexture(m_id, "Texture3D::getData");
+            if (GLAD_GL_VERSION_4_5) {
+                glGetTextureImage(m_id, level, m_format, m_type, dataSize(level), data);
+            } else {
+                bind();
+                glGetTexImage(GL_TEXTURE_3D, level, m_format, m_type, data);
+            }
+        }
+
+        void generateMipmaps() const {
+            State::syncTexture(m_id, "Texture3D::generateMipmaps");
+            if (GLAD_GL_VERSION_4_5) {
+                glGenerateTextureMipmap(m_id);
+            } else {
+                bind();
+                glGenerateMipmap(GL_TEXTURE_3D);
+            }
+        }
+
+        void setParameters(GLenum minFilter, GLenum magFilter, GLenum wrapS, GLenum wrapT, GLenum wrapR) const {
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, wrapS);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, wrapT);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_R, wrapR);
+            } else {
+                bind();
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, wrapS);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, wrapT);
+                glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, wrapR);
+            }
+        }
+
+        void label(const char* name) {
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
+                glObjectLabel(GL_TEXTURE, m_id, -1, name);
+        }
+
+        GLsizei levelWidth(GLint level) const { return std::max(1, m_width >> level); }
+        GLsizei levelHeight(GLint level) const { return std::max(1, m_height >> level); }
+        GLsizei levelDepth(GLint level) const { return std::max(1, m_depth >> level); }
+        GLsizei dataSize(GLint level) const { return ((levelWidth(level) * PixelSize(m_format, m_type) + 3) & ~3) * levelHeight(level) * levelDepth(level); }
+
+        GLsizei width() const { return m_width; }
+        GLsizei height() const { return m_height; }
+        GLsizei depth() const { return m_depth; }
+        GLsizei levels() const { return m_levels; }
+        GLenum internalFormat() const { return m_internalFormat; }
+        GLenum format() const { return m_format; }
+        GLenum type() const { return m_type; }
+
+    private:
+        GLuint m_id{0};
+        GLsizei m_width{0}, m_height{0}, m_depth{0};
+        GLsizei m_levels{1};
+        GLenum m_internalFormat{0}, m_format{0}, m_type{0};
+    };
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <algorithm>
+#include <utility>
+
+namespace gl {
+
+    // Six square faces in the GL order +X, -X, +Y, -Y, +Z, -Z; face indices below are 0-5.
+    // The DSA paths address a face as layer `face` of the cube map, the fallback through
+    // GL_TEXTURE_CUBE_MAP_POSITIVE_X + face.
+    class TextureCube {
+    public:
+        TextureCube() = default;
+        ~TextureCube() { destroy(); }
+
+        TextureCube(const TextureCube&) = delete;
+        TextureCube& operator=(const TextureCube&) = delete;
+
+        TextureCube(TextureCube&& other) noexcept { *this = std::move(other); }
+        TextureCube& operator=(TextureCube&& other) noexcept {
+            if (this != &other) {
+                destroy();
+                m_id = other.m_id;
+                m_size = other.m_size;
+                m_levels = other.m_levels;
+                m_internalFormat = other.m_internalFormat;
+                m_format = other.m_format;
+                m_type = other.m_type;
+                other.m_id = 0;
+            }
+            return *this;
+        }
+
+        void create(GLsizei size, GLenum internalFormat, GLenum format, GLenum type, GLsizei levels = 1) {
+            if (m_id) return;
+
+            m_id = State::names().texturesCube.acquire();
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureStorage2D(m_id, levels, internalFormat, size, size);
+            } else {
+                bind();
+                glTexStorage2D(GL_TEXTURE_CUBE_MAP, levels, internalFormat, size, size);
+            }
+
+            m_size = size;
+            m_internalFormat = internalFormat;
+            m_format = format;
+            m_type = type;
+            m_levels = levels;
+        }
+
+        void destroy() {
+            if (!m_id) return;
+            State::forgetTexture(m_id);
+            glDeleteTextures(1, &m_id);
+            m_id = 0;
+        }
+
+        bool valid() const { return m_id != 0 && glIsTexture(m_id); }
+        GLuint get() const { return m_id; }
+
+        void bind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_CUBE_MAP, m_id); }
+        void unbind(GLuint unit = 0) const { State::bindTexture(unit, GL_TEXTURE_CUBE_MAP, 0); }
+
+        // Binds all faces (imageCube), or one face as a plain image2D when face >= 0.
+        void bindImage(GLuint unit, GLenum access = GL_READ_WRITE, GLint level = 0, GLint face = -1) const {
+            State::bindImageTexture(unit, m_id, level, face < 0 ? GL_TRUE : GL_FALSE, std::max(face, 0), access, m_internalFormat, m_internalFormat);
+        }
+
+        void setFace(GLint face, const void* data) const { setSubData(face, 0, 0, 0, m_size, m_size, data); }
+
+        // With a GL_PIXEL_UNPACK_BUFFER bound, data is a byte offset into that buffer.
+        void setSubData(GLint face, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, const void* data) const {
+            State::syncTexture(m_id, "TextureCube::setSubData");
+            GLBALLISTIC_STAT(State::countUpload(static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(PixelSize(m_format, m_type))));
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureSubImage3D(m_id, level, x, y, face, width, height, 1, m_format, m_type, data);
+            } else {
+                bind();
+                glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(face), level, x, y, width, height, m_format, m_type, data);
+            }
+        }
+
+        void getFace(GLint face, void* data, GLint level = 0) const {
+            State::syncTexture(m_id, "TextureCube::getFace");
+            if (GLAD_GL_VERSION_4_5) {
+                glGetTextureSubImage(m_id, level, 0, 0, face, levelSize(level), levelSize(level), 1, m_format, m_type, faceSize(level), data);
+            } else {
+                bind();
+                glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + static_cast<GLenum>(face), level, m_format, m_type, data);
+            }
+        }
+
+        void generateMipmaps() const {
+            State::syncTexture(m_id, "TextureCube::generateMipmaps");
+            if (GLAD_GL_VERSION_4_5) {
+                glGenerateTextureMipmap(m_id);
+            } else {
+                bind();
+                glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+            }
+        }
+
+        void setParameters(GLenum minFilter, GLenum magFilter, GLenum wrap = GL_CLAMP_TO_EDGE) const {
+            if (GLAD_GL_VERSION_4_5) {
+                glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, wrap);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, wrap);
+                glTextureParameteri(m_id, GL_TEXTURE_WRAP_R, wrap);
+            } else {
+                bind();
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, minFilter);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, magFilter);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, wrap);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, wrap);
+                glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, wrap);
+            }
+        }
+
+        void label(const char* name) {
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
+                glObjectLabel(GL_TEXTURE, m_id, -1, name);
+        }
+
+        GLsizei levelSize(GLint level) const { return std::max(1, m_size >> level); }
+        GLsizei faceSize(GLint level) const { return ((levelSize(level) * PixelSize(m_format, m_type) + 3) & ~3) * levelSize(level); }
+
+        GLsizei size() const { return m_size; }
+        GLsizei levels() const { return m_levels; }
+        GLenum internalFormat() const { return m_internalFormat; }
+        GLenum format() const { return m_format; }
+        GLenum type() const { return m_type; }
+
+    private:
+        GLuint m_id{0};
+        GLsizei m_size{0};
+        GLsizei m_levels{1};
+        GLenum m_internalFormat{0}, m_format{0}, m_type{0};
+    };
+
+}
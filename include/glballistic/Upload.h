@@ -0,0 +1,167 @@
+#pragma once
+#include <glad/glad.h>
+#include <glballistic/State.h>
+#include <glballistic/Misc.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/Fence.h>
+#include <glballistic/Texture2D.h>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace gl {
+
+    struct StagedUpload {
+        unsigned char* data{nullptr};
+        GLintptr offset{0};
+        GLsizeiptr size{0};
+        uint64_t serial{0};
+
+        explicit operator bool() const { return data != nullptr; }
+    };
+
+    // Ring of persistently mapped GL_PIXEL_UNPACK_BUFFER memory for texture uploads.
+    // stage() reserves space on the GL thread; the returned pointer may be filled from any
+    // thread, and upload() then issues the copy from the buffer offset on the GL thread.
+    // Each submitted region is fenced and only reused once the GPU has consumed it.
+    class UploadPool {
+    public:
+        UploadPool() = default;
+        ~UploadPool() { destroy(); }
+
+        UploadPool(const UploadPool&) = delete;
+        UploadPool& operator=(const UploadPool&) = delete;
+
+        void create(GLsizeiptr capacity) {
+            if (m_buffer.get()) return;
+
+            m_capacity = capacity;
+            m_head = 0;
+            m_buffer.create(GL_PIXEL_UNPACK_BUFFER);
+
+            if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+                GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                m_buffer.storage(capacity, nullptr, flags);
+                m_mapped = static_cast<unsigned char*>(m_buffer.mapRange(0, capacity, flags));
+            } else {
+                m_buffer.data(capacity, nullptr, GL_STREAM_DRAW);
+                m_staging.resize(static_cast<size_t>(capacity));
+                m_mapped = m_staging.data();
+            }
+        }
+
+        void destroy() {
+            m_inflight.clear();
+            if (m_mapped && m_staging.empty())
+                m_buffer.unmap();
+            m_mapped = nullptr;
+            m_staging.clear();
+            m_buffer.destroy();
+            m_capacity = 0;
+            m_head = 0;
+        }
+
+        // Returns an empty region when the request is larger than the pool or the space it
+        // needs is still held by a region that was staged but never uploaded.
+        StagedUpload stage(GLsizeiptr size) {
+            if (!m_mapped || size <= 0 || size > m_capacity) return {};
+
+            GLintptr start = (m_head + Alignment - 1) / Alignment * Alignment;
+            if (start + size > m_capacity) start = 0;
+            GLintptr end = start + size;
+
+            size_t blocking = 0;
+            for (size_t i = 0; i < m_inflight.size(); i++) {
+                if (m_inflight[i].begin < end && start < m_inflight[i].end)
+                    blocking = i + 1;
+            }
+
+            for (size_t i = 0; i < blocking; i++) {
+                if (!m_inflight[i].submitted) return {};
+            }
+            for (size_t i = 0; i < blocking; i++) {
+                m_inflight.front().fence.wait();
+                m_inflight.pop_front();
+            }
+
+            m_head = end;
+            m_inflight.push_back({start, end, ++m_serial, false, Fence()});
+            return {m_mapped + start, start, size, m_serial};
+        }
+
+        void upload(const Texture2D& texture, const StagedUpload& region, GLint level, GLint x, GLint y, GLsizei width, GLsizei height) {
+            Entry* entry = find(region.serial);
+            if (!entry) return;
+
+            if (!m_staging.empty())
+                m_buffer.update(region.offset, region.size, region.data);
+
+            State::bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer.get());
+            texture.setSubData(level, x, y, width, height, reinterpret_cast<const void*>(region.offset));
+            State::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+            entry->fence.create();
+            entry->submitted = true;
+        }
+
+        // Copies pixels into the ring and uploads them; falls back to a direct client-memory
+        // upload when the ring has no room.
+        void upload(const Texture2D& texture, const void* pixels, GLint level, GLint x, GLint y, GLsizei width, GLsizei height) {
+            if (width <= 0 || height <= 0) return;
+            GLsizeiptr rowBytes = static_cast<GLsizeiptr>(width) * PixelSize(texture.format(), texture.type());
+            GLsizeiptr rowPitch = (rowBytes + 3) & ~GLsizeiptr(3);
+            StagedUpload region = stage(rowPitch * height);
+            if (!region) {
+                texture.setSubData(level, x, y, width, height, pixels);
+                return;
+            }
+
+            // The last row needs no alignment padding, so the caller's buffer may end right
+            // after its last pixel.
+            std::memcpy(region.data, pixels, static_cast<size_t>(rowPitch * (height - 1) + rowBytes));
+            upload(texture, region, level, x, y, width, height);
+        }
+
+        void upload(const Texture2D& texture, const void* pixels, GLint level = 0) {
+            upload(texture, pixels, level, 0, 0, texture.levelWidth(level), texture.levelHeight(level));
+        }
+
+        // Drops bookkeeping for regions the GPU has finished with, without blocking.
+        void retire() {
+            while (!m_inflight.empty() && m_inflight.front().submitted && m_inflight.front().fence.signaled())
+                m_inflight.pop_front();
+        }
+
+        GLsizeiptr capacity() const { return m_capacity; }
+        size_t inflight() const { return m_inflight.size(); }
+        bool persistent() const { return m_mapped && m_staging.empty(); }
+        GLuint get() const { return m_buffer.get(); }
+
+    private:
+        static constexpr GLintptr Alignment = 16;
+
+        struct Entry {
+            GLintptr begin, end;
+            uint64_t serial;
+            bool submitted;
+            Fence fence;
+        };
+
+        Buffer m_buffer;
+        unsigned char* m_mapped{nullptr};
+        std::vector<unsigned char> m_staging;
+        std::deque<Entry> m_inflight;
+        GLsizeiptr m_capacity{0};
+        GLintptr m_head{0};
+        uint64_t m_serial{0};
+
+        Entry* find(uint64_t serial) {
+            for (auto& entry : m_inflight) {
+                if (entry.serial == serial) return &entry;
+            }
+            return nullptr;
+        }
+    };
+
+}
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 #include <glad/glad.h>
 #include <glballistic/State.h>
+#include <glballistic/Profiler.h>
+#include <glballistic/Buffer.h>
+#include <glballistic/IndirectCommandBuffer.h>
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -26,14 +30,12 @@ namespace gl {
 
         void create() {
             if (m_id) return;
-            if (GLAD_GL_VERSION_4_5)
-                glCreateVertexArrays(1, &m_id);
-            else
-                glGenVertexArrays(1, &m_id);
+            m_id = State::names().vertexArrays.acquire();
         }
 
         void destroy() {
             if (!m_id) return;
+            State::hazards().forgetVertexArray(m_id);
             glDeleteVertexArrays(1, &m_id);
             m_id = 0;
         }
@@ -45,6 +47,7 @@ namespace gl {
         void unbind() const { State::bindVertexArray(0); }
 
         void vertexBuffer(GLuint bindingIndex, GLuint buffer, GLintptr offset = 0, GLsizei stride = 0) {
+            if (State::hazards().enabled()) State::hazards().vertexArrayBuffer(m_id, bindingIndex, buffer);
             if (GLAD_GL_VERSION_4_5)
                 glVertexArrayVertexBuffer(m_id, bindingIndex, buffer, offset, stride);
             else {
@@ -53,7 +56,9 @@ namespace gl {
             }
         }
 
-        void indexBuffer(GLuint buffer) {
+        void indexBuffer(GLuint buffer, GLenum type = GL_UNSIGNED_INT) {
+            m_indexType = type;
+            if (State::hazards().enabled()) State::hazards().vertexArrayElements(m_id, buffer);
             if (GLAD_GL_VERSION_4_5)
                 glVertexArrayElementBuffer(m_id, buffer);
             else {
@@ -102,7 +107,11 @@ namespace gl {
         }
 
         void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount = 1) const {
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::drawArrays");
             bind();
+            State::flush();
+            State::syncDraw(false);
+            GLBALLISTIC_STAT(State::countDraw());
             if (instanceCount > 1)
                 glDrawArraysInstanced(mode, first, count, instanceCount);
             else
@@ -111,13 +120,121 @@ namespace gl {
 
 
         void drawElements(GLenum mode, GLsizei count, const void* indices = nullptr, GLsizei instanceCount = 1) const {
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::drawElements");
             bind();
+            State::flush();
+            State::syncDraw(true);
+            GLBALLISTIC_STAT(State::countDraw());
             if (instanceCount > 1)
                 glDrawElementsInstanced(mode, count, m_indexType, indices, instanceCount);
             else
                 glDrawElements(mode, count, m_indexType, indices);
         }
 
+        // indices is a byte offset into the element buffer; baseVertex is added to every index
+        // fetched. A non-zero baseInstance needs GL 4.2 / ARB_base_instance.
+        void drawElementsBaseVertex(GLenum mode, GLsizei count, const void* indices, GLint baseVertex, GLsizei instanceCount = 1, GLuint baseInstance = 0) const {
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::drawElementsBaseVertex");
+            bind();
+            State::flush();
+            State::syncDraw(true);
+            GLBALLISTIC_STAT(State::countDraw());
+            if (baseInstance)
+                glDrawElementsInstancedBaseVertexBaseInstance(mode, count, m_indexType, indices, instanceCount, baseVertex, baseInstance);
+            else if (instanceCount > 1)
+                glDrawElementsInstancedBaseVertex(mode, count, m_indexType, indices, instanceCount, baseVertex);
+            else
+                glDrawElementsBaseVertex(mode, count, m_indexType, indices, baseVertex);
+        }
+
+        // Submits drawCount commands starting at byte offset in the indirect buffer. Without
+        // GL 4.3 / ARB_multi_draw_indirect each command becomes its own glDraw*Indirect call.
+        void multiDrawArraysIndirect(GLenum mode, const Buffer& commands, GLintptr offset, GLsizei drawCount, GLsizei stride = 0) const {
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::multiDrawArraysIndirect");
+            if (drawCount <= 0) return;
+            beginIndirect(commands);
+            State::syncDraw(false, true);
+            GLBALLISTIC_STAT(State::countDraw());
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect) {
+                glMultiDrawArraysIndirect(mode, indirectOffset(offset), drawCount, stride);
+                return;
+            }
+            GLsizei step = stride ? stride : static_cast<GLsizei>(sizeof(DrawArraysIndirectCommand));
+            for (GLsizei i = 0; i < drawCount; i++)
+                glDrawArraysIndirect(mode, indirectOffset(offset + static_cast<GLintptr>(i) * step));
+        }
+
+        void multiDrawElementsIndirect(GLenum mode, const Buffer& commands, GLintptr offset, GLsizei drawCount, GLsizei stride = 0) const {
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::multiDrawElementsIndirect");
+            if (drawCount <= 0) return;
+            beginIndirect(commands);
+            State::syncDraw(true, true);
+            GLBALLISTIC_STAT(State::countDraw());
+            if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect) {
+                glMultiDrawElementsIndirect(mode, m_indexType, indirectOffset(offset), drawCount, stride);
+                return;
+            }
+            GLsizei step = stride ? stride : static_cast<GLsizei>(sizeof(DrawElementsIndirectCommand));
+            for (GLsizei i = 0; i < drawCount; i++)
+                glDrawElementsIndirect(mode, m_indexType, indirectOffset(offset + static_cast<GLintptr>(i) * step));
+        }
+
+        // The number of draws is read on the GPU from a GLuint at countOffset in parameters,
+        // clamped to maxDrawCount. Without GL 4.6 / ARB_indirect_parameters the count is read
+        // back to the CPU first, which stalls until the GPU has written it.
+        void multiDrawArraysIndirectCount(GLenum mode, const Buffer& commands, GLintptr offset, const Buffer& parameters, GLintptr countOffset, GLsizei maxDrawCount, GLsizei stride = 0) const {
+            if (!hasIndirectCount()) {
+                multiDrawArraysIndirect(mode, commands, offset, readDrawCount(parameters, countOffset, maxDrawCount), stride);
+                return;
+            }
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::multiDrawArraysIndirectCount");
+            beginIndirect(commands);
+            State::bindBuffer(GL_PARAMETER_BUFFER, parameters.get());
+            State::syncDraw(false, true);
+            GLBALLISTIC_STAT(State::countDraw());
+            if (GLAD_GL_VERSION_4_6)
+                glMultiDrawArraysIndirectCount(mode, indirectOffset(offset), countOffset, maxDrawCount, stride);
+            else
+                glMultiDrawArraysIndirectCountARB(mode, indirectOffset(offset), countOffset, maxDrawCount, stride);
+        }
+
+        void multiDrawElementsIndirectCount(GLenum mode, const Buffer& commands, GLintptr offset, const Buffer& parameters, GLintptr countOffset, GLsizei maxDrawCount, GLsizei stride = 0) const {
+            if (!hasIndirectCount()) {
+                multiDrawElementsIndirect(mode, commands, offset, readDrawCount(parameters, countOffset, maxDrawCount), stride);
+                return;
+            }
+            GLBALLISTIC_PROFILE_ZONE("VertexArray::multiDrawElementsIndirectCount");
+            beginIndirect(commands);
+            State::bindBuffer(GL_PARAMETER_BUFFER, parameters.get());
+            State::syncDraw(true, true);
+            GLBALLISTIC_STAT(State::countDraw());
+            if (GLAD_GL_VERSION_4_6)
+                glMultiDrawElementsIndirectCount(mode, m_indexType, indirectOffset(offset), countOffset, maxDrawCount, stride);
+            else
+                glMultiDrawElementsIndirectCountARB(mode, m_indexType, indirectOffset(offset), countOffset, maxDrawCount, stride);
+        }
+
+        // Draws everything last uploaded to the command buffer.
+        void multiDrawArraysIndirect(GLenum mode, const DrawArraysCommandBuffer& commands) const {
+            multiDrawArraysIndirect(mode, commands.buffer(), 0, commands.uploaded());
+        }
+
+        void multiDrawElementsIndirect(GLenum mode, const DrawElementsCommandBuffer& commands) const {
+            multiDrawElementsIndirect(mode, commands.buffer(), 0, commands.uploaded());
+        }
+
+        void multiDrawArraysIndirectCount(GLenum mode, const DrawArraysCommandBuffer& commands, const Buffer& parameters, GLintptr countOffset = 0) const {
+            multiDrawArraysIndirectCount(mode, commands.buffer(), 0, parameters, countOffset, commands.capacity());
+        }
+
+        void multiDrawElementsIndirectCount(GLenum mode, const DrawElementsCommandBuffer& commands, const Buffer& parameters, GLintptr countOffset = 0) const {
+            multiDrawElementsIndirectCount(mode, commands.buffer(), 0, parameters, countOffset, commands.capacity());
+        }
+
+        static bool hasIndirectCount() { return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_indirect_parameters; }
+
+        GLenum indexType() const { return m_indexType; }
+
         void label(const char* name) {
             if (GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug)
                 glObjectLabel(GL_VERTEX_ARRAY, m_id, -1, name);
@@ -126,6 +243,26 @@ namespace gl {
     private:
         GLuint m_id{0};
         GLenum m_indexType{GL_UNSIGNED_INT};
+
+        void beginIndirect(const Buffer& commands) const {
+            bind();
+            State::bindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.get());
+            State::flush();
+        }
+
+        static const void* indirectOffset(GLintptr offset) { return reinterpret_cast<const void*>(offset); }
+
+        static GLsizei readDrawCount(const Buffer& parameters, GLintptr countOffset, GLsizei maxDrawCount) {
+            GLuint count = 0;
+            State::syncBuffer(parameters.get(), "VertexArray::readDrawCount");
+            if (GLAD_GL_VERSION_4_5)
+                glGetNamedBufferSubData(parameters.get(), countOffset, sizeof(GLuint), &count);
+            else {
+                State::bindBuffer(GL_COPY_READ_BUFFER, parameters.get());
+                glGetBufferSubData(GL_COPY_READ_BUFFER, countOffset, sizeof(GLuint), &count);
+            }
+            return std::min(static_cast<GLsizei>(count), maxDrawCount);
+        }
     };
 
 }
\ No newline at end of file
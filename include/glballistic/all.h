@@ -1,11 +1,32 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glballistic/RenderState.h>
+#include <glballistic/Names.h>
+#include <glballistic/Hazards.h>
 #include <glballistic/State.h>
+#include <glballistic/Profiler.h>
 #include <glballistic/Misc.h>
+#include <glballistic/Fence.h>
 #include <glballistic/Buffer.h>
+#include <glballistic/Allocator.h>
+#include <glballistic/StreamBuffer.h>
+#include <glballistic/IndirectCommandBuffer.h>
 #include <glballistic/VertexArray.h>
 #include <glballistic/Shader.h>
+#include <glballistic/ProgramCache.h>
+#include <glballistic/BlockLayout.h>
 #include <glballistic/Texture2D.h>
+#include <glballistic/Texture2DArray.h>
+#include <glballistic/Texture3D.h>
+#include <glballistic/TextureCube.h>
+#include <glballistic/Atlas.h>
+#include <glballistic/Readback.h>
+#include <glballistic/Upload.h>
 #include <glballistic/Renderbuffer.h>
-#include <glballistic/Framebuffer.h>
\ No newline at end of file
+#include <glballistic/Framebuffer.h>
+#include <glballistic/Pool.h>
+#include <glballistic/FrameGraph.h>
+#include <glballistic/Culling.h>
+#include <glballistic/RenderQueue.h>
+#include <glballistic/GeometryArena.h>
\ No newline at end of file